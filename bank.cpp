@@ -0,0 +1,198 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "metadata.h"
+#include "preset_bank.h"
+#include "call_faust.h"
+#include "messages.h"
+#include "thirdparty/pugixml.hpp"
+#include "thirdparty/gsl-lite.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+
+struct Cmd_Args {
+    std::string dspfile;
+    std::string presetfile;
+    std::string bankfile;
+    Faust_Args faustargs;
+};
+
+static void display_usage();
+static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[]);
+static int read_presets(std::istream &in, const Metadata &md, std::vector<Preset> &presets);
+
+int main(int argc, char *argv[])
+{
+    Cmd_Args cmd;
+    if (do_cmdline(cmd, argc, argv) == -1) {
+        display_usage();
+        return 1;
+    }
+
+    pugi::xml_document doc;
+    if (call_faust(cmd.dspfile, doc, cmd.faustargs) == -1) {
+        errs() << "The faust command has failed.\n";
+        return 1;
+    }
+
+    Metadata md;
+    if (extract_metadata(doc, md) == -1) {
+        errs() << "Could not extract the faust metadata.\n";
+        return 1;
+    }
+
+    std::ifstream in(cmd.presetfile);
+    std::vector<Preset> presets;
+    if (!in || read_presets(in, md, presets) == -1) {
+        errs() << "Could not read the presets.\n";
+        return 1;
+    }
+
+    // the values are FAUSTFLOAT, like in the code of `faustmd` with the same flags
+    unsigned value_size = faust_float_size(cmd.faustargs);
+    std::ofstream out(cmd.bankfile, std::ios::binary);
+    if (!out || write_preset_bank(out, md, presets, value_size) == -1 || (out.flush(), !out)) {
+        errs() << "Could not write the preset bank.\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+static void display_usage()
+{
+    std::cerr << "Usage: faustmd-bank [-I path]* [-cn name] [-pn name] <file.dsp> <presets.txt> <bank.bin>\n";
+}
+
+static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[])
+{
+    bool moreflags = true;
+    unsigned extraindex = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        gsl::string_span arg = argv[i];
+
+        if (moreflags && arg == "--")
+            moreflags = false;
+        else if (moreflags && arg == "-I") {
+            if (++i == argc) {
+                errs() << "The flag `-I` requires an argument.\n";
+                return -1;
+            }
+            cmd.faustargs.incdirs.push_back(argv[i]);
+        }
+        else if (moreflags && arg == "-cn") {
+            if (++i == argc) {
+                errs() << "The flag `-cn` requires an argument.\n";
+                return -1;
+            }
+            cmd.faustargs.classname = argv[i];
+        }
+        else if (moreflags && arg == "-pn") {
+            if (++i == argc) {
+                errs() << "The flag `-pn` requires an argument.\n";
+                return -1;
+            }
+            cmd.faustargs.processname = argv[i];
+        }
+        else if (moreflags && arg.subspan(0, 2) == "-X") {
+            cmd.faustargs.miscargs.emplace_back(arg.begin() + 2, arg.end());
+        }
+        else if (moreflags && !arg.empty() && arg[0] == '-') {
+            errs() << "Unrecognized flag `" << arg << "`\n";
+            return -1;
+        }
+        else {
+            switch (extraindex) {
+            case 0:
+                cmd.dspfile = gsl::to_string(arg);
+                break;
+            case 1:
+                cmd.presetfile = gsl::to_string(arg);
+                break;
+            case 2:
+                cmd.bankfile = gsl::to_string(arg);
+                break;
+            default:
+                errs() << "Unrecognized positional argument `" << arg << "`\n";
+                return -1;
+            }
+            ++extraindex;
+        }
+    }
+
+    if (extraindex != 3) {
+        errs() << "There must be exactly three positional arguments.\n";
+        return -1;
+    }
+
+    return 0;
+}
+
+static const std::string trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end + 1 - begin);
+}
+
+// The presets are sections of `symbol = value` lines, under a `[name]`
+// header. The controls which a preset does not mention keep their default.
+static int read_presets(std::istream &in, const Metadata &md, std::vector<Preset> &presets)
+{
+    std::string line;
+    for (unsigned lineno = 1; std::getline(in, line); ++lineno) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';')
+            continue;
+
+        if (line[0] == '[') {
+            if (line.back() != ']') {
+                errs() << "Line " << lineno << ": invalid preset header.\n";
+                return -1;
+            }
+            Preset p;
+            p.name = line.substr(1, line.size() - 2);
+            for (const Metadata::Widget &w : md.active)
+                p.values.push_back(w.init);
+            presets.push_back(std::move(p));
+            continue;
+        }
+
+        size_t equal = line.find('=');
+        if (presets.empty() || equal == std::string::npos) {
+            errs() << "Line " << lineno << ": expected a value assignment in a preset.\n";
+            return -1;
+        }
+
+        std::string symbol = trim(line.substr(0, equal));
+        std::string value = trim(line.substr(equal + 1));
+
+        int index = -1;
+        for (size_t i = 0, n = md.active.size(); i < n && index == -1; ++i) {
+            if (md.active[i].symbol == symbol)
+                index = (int)i;
+        }
+        if (index == -1) {
+            warns() << "Line " << lineno << ": unknown control `" << symbol << "`\n";
+            continue;
+        }
+
+        char *end;
+        double number = std::strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0') {
+            errs() << "Line " << lineno << ": invalid value `" << value << "`\n";
+            return -1;
+        }
+        presets.back().values[index] = number;
+    }
+
+    return in.bad() ? -1 : 0;
+}
@@ -0,0 +1,272 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// Compilation cost of the generated metadata, by size and shape of output.
+// Synthetic DSPs go through `dump_metadata`, and the host compiler builds
+// each result; for each, it reports the compile time and the peak memory of
+// the compiler, with the time of the bare DSP class subtracted, the size of
+// the object and its count of relocations.
+
+#include "../metadata.h"
+#include "../messages.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <elf.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+struct Variant {
+    const char *name;
+    Dump_Args args;
+};
+
+struct Compile_Result {
+    double seconds = 0;
+    long peak_kb = 0;
+    long object_size = 0;
+    long relocations = 0;
+};
+
+static Metadata synthetic_metadata(unsigned actives, unsigned passives);
+static void write_source(const std::string &path, const Metadata &md, const std::string &header);
+static int compile(const std::string &compiler, const std::string &source, const std::string &object, Compile_Result &res);
+static long count_relocations(const std::string &path);
+
+int main(int argc, char *argv[])
+{
+    unsigned max_widgets = 10000;
+    if (argc > 2 || (argc == 2 && (max_widgets = std::strtoul(argv[1], nullptr, 10)) == 0)) {
+        std::cerr << "Usage: faustmd-bench [max-widgets]\n";
+        return 1;
+    }
+
+    const char *compiler = std::getenv("CXX");
+    if (!compiler || !*compiler)
+        compiler = "c++";
+
+    char dirtemplate[] = "/tmp/faustmd-bench.XXXXXX";
+    if (!mkdtemp(dirtemplate)) {
+        errs() << "Could not create the temporary directory.\n";
+        return 1;
+    }
+    std::string dir = dirtemplate;
+
+    std::vector<Variant> variants;
+    {
+        // per-widget functions and arrays, at any size
+        Variant v{"functions", Dump_Args()};
+        v.args.large_ui_threshold = (size_t)-1;
+        variants.push_back(v);
+    }
+    {
+        Variant v{"tables", Dump_Args()};
+        v.args.large_ui = true;
+        variants.push_back(v);
+    }
+    {
+        Variant v{"tables+pool", Dump_Args()};
+        v.args.large_ui = true;
+        v.args.pooled_strings = true;
+        variants.push_back(v);
+    }
+
+    std::printf("%-12s %8s %10s %10s %12s %10s\n", "output", "widgets", "seconds", "peak KiB", "object B", "relocs");
+
+    for (unsigned widgets = 100; widgets <= max_widgets; widgets *= 10) {
+        Metadata md = synthetic_metadata(widgets - widgets / 10, widgets / 10);
+
+        std::string source = dir + "/base.cpp";
+        std::string object = dir + "/base.o";
+        write_source(source, md, std::string());
+        Compile_Result base;
+        if (compile(compiler, source, object, base) == -1) {
+            errs() << "Could not compile the synthetic DSP.\n";
+            return 1;
+        }
+
+        for (const Variant &v : variants) {
+            std::string header = dir + "/bench_meta.h";
+            std::ofstream out(header);
+            dump_metadata(out, md, v.args);
+            out.flush();
+            if (!out) {
+                errs() << "Could not write the header.\n";
+                return 1;
+            }
+
+            source = dir + "/bench.cpp";
+            object = dir + "/bench.o";
+            write_source(source, md, header);
+            Compile_Result res;
+            if (compile(compiler, source, object, res) == -1) {
+                errs() << "Could not compile the header of `" << v.name << "`.\n";
+                return 1;
+            }
+
+            std::printf("%-12s %8u %10.3f %10ld %12ld %10ld\n", v.name, widgets,
+                        res.seconds - base.seconds, res.peak_kb, res.object_size, res.relocations);
+            std::fflush(stdout);
+        }
+    }
+
+    for (const char *file : {"base.cpp", "base.o", "bench.cpp", "bench.o", "bench_meta.h"})
+        unlink((dir + "/" + file).c_str());
+    rmdir(dir.c_str());
+
+    return 0;
+}
+
+static Metadata synthetic_metadata(unsigned actives, unsigned passives)
+{
+    Metadata md;
+    md.name = "bench";
+    md.author = "faustmd";
+    md.version = "1.0";
+    md.classname = "benchdsp";
+    md.inputs = 2;
+    md.outputs = 2;
+    md.metadata.emplace_back("name", "bench");
+
+    Metadata::Group root;
+    root.type = Metadata::Group::Type::VGroup;
+    root.label = "bench";
+    root.address = "/bench";
+    root.active_end = actives;
+    root.passive_end = passives;
+    md.groups.push_back(root);
+
+    int id = 0;
+    for (unsigned i = 0; i < actives; ++i) {
+        Metadata::Widget w;
+        w.type = Metadata::Widget::Type::HSlider;
+        w.id = ++id;
+        w.label = "param " + std::to_string(i);
+        w.var = "fHslider" + std::to_string(i);
+        w.symbol = "param_" + std::to_string(i);
+        w.address = "/bench/param_" + std::to_string(i);
+        w.init = 0.5;
+        w.min = 0;
+        w.max = 1;
+        w.step = 0.01;
+        // a mix of controls without and with metadata
+        if (i % 2) {
+            w.metadata.emplace_back("style", "knob");
+            w.metadata.emplace_back("unit", "dB");
+            w.unit = "dB";
+        }
+        if (i % 4 == 1) {
+            w.metadata.emplace_back("tooltip", "Parameter " + std::to_string(i));
+            w.tooltip = "Parameter " + std::to_string(i);
+        }
+        md.active.push_back(w);
+    }
+
+    for (unsigned i = 0; i < passives; ++i) {
+        Metadata::Widget w;
+        w.type = Metadata::Widget::Type::HBarGraph;
+        w.id = ++id;
+        w.label = "meter " + std::to_string(i);
+        w.var = "fHbargraph" + std::to_string(i);
+        w.symbol = "meter_" + std::to_string(i);
+        w.address = "/bench/meter_" + std::to_string(i);
+        w.min = -60;
+        w.max = 0;
+        md.passive.push_back(w);
+    }
+
+    return md;
+}
+
+static void write_source(const std::string &path, const Metadata &md, const std::string &header)
+{
+    std::ofstream out(path);
+    out << "#define FAUSTFLOAT float" "\n";
+    out << "class " << md.classname << " {" "\n";
+    out << "public:" "\n";
+    for (const std::vector<Metadata::Widget> *widgets : {&md.active, &md.passive}) {
+        for (const Metadata::Widget &w : *widgets)
+            out << "\t" "FAUSTFLOAT " << w.var << ";" "\n";
+    }
+    out << "};" "\n";
+    out << "#define FAUSTCLASS " << md.classname << "\n";
+    if (!header.empty())
+        out << "#include \"" << header << "\"" "\n";
+}
+
+static int compile(const std::string &compiler, const std::string &source, const std::string &object, Compile_Result &res)
+{
+    // without optimization, unreferenced static tables are kept in the object
+    std::vector<std::string> args = {compiler, "-std=c++11", "-O0", "-fPIC", "-w", "-c", "-o", object, source};
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+        argv.push_back(&arg[0]);
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (pid == -1)
+        return -1;
+    if (pid == 0) {
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == -1)
+        return -1;
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return -1;
+
+    struct stat st;
+    if (stat(object.c_str(), &st) == -1)
+        return -1;
+
+    res.seconds = std::chrono::duration<double>(end - start).count();
+    res.peak_kb = usage.ru_maxrss;
+    res.object_size = st.st_size;
+    res.relocations = count_relocations(object);
+    return 0;
+}
+
+static long count_relocations(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    // 64-bit ELF only, in host byte order
+    Elf64_Ehdr eh;
+    if (data.size() < sizeof(eh))
+        return -1;
+    std::memcpy(&eh, data.data(), sizeof(eh));
+    if (std::memcmp(eh.e_ident, ELFMAG, SELFMAG) != 0 || eh.e_ident[EI_CLASS] != ELFCLASS64)
+        return -1;
+
+    long count = 0;
+    for (unsigned i = 0; i < eh.e_shnum; ++i) {
+        Elf64_Shdr sh;
+        size_t offset = eh.e_shoff + i * (size_t)eh.e_shentsize;
+        if (offset + sizeof(sh) > data.size())
+            return -1;
+        std::memcpy(&sh, data.data() + offset, sizeof(sh));
+        if ((sh.sh_type == SHT_RELA || sh.sh_type == SHT_REL) && sh.sh_entsize > 0)
+            count += sh.sh_size / sh.sh_entsize;
+    }
+
+    return count;
+}
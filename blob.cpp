@@ -0,0 +1,101 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "blob.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cassert>
+
+Blob_Writer::Blob_Writer(const std::string &prefix, unsigned float_size)
+    : prefix_(prefix), float_size_(float_size)
+{
+    assert(float_size == sizeof(float) || float_size == sizeof(double));
+}
+
+void Blob_Writer::add_floats(const std::string &name, const std::vector<double> &values)
+{
+    size_t count = std::max<size_t>(1, values.size());
+    std::string bytes(count * float_size_, '\0');
+    for (size_t i = 0, n = values.size(); i < n; ++i) {
+        char *dst = &bytes[i * float_size_];
+        if (float_size_ == sizeof(float))
+            { float value = values[i]; std::memcpy(dst, &value, sizeof(float)); }
+        else
+            { double value = values[i]; std::memcpy(dst, &value, sizeof(double)); }
+    }
+    add(name, bytes.data(), bytes.size(), float_size_);
+}
+
+void Blob_Writer::add_integers(const std::string &name, const std::vector<int64_t> &values, unsigned size)
+{
+    assert(size == 1 || size == 2 || size == 4 || size == 8);
+
+    size_t count = std::max<size_t>(1, values.size());
+    std::string bytes(count * size, '\0');
+    for (size_t i = 0, n = values.size(); i < n; ++i) {
+        char *dst = &bytes[i * size];
+        switch (size) {
+        case 1: { int8_t value = values[i]; std::memcpy(dst, &value, 1); break; }
+        case 2: { int16_t value = values[i]; std::memcpy(dst, &value, 2); break; }
+        case 4: { int32_t value = values[i]; std::memcpy(dst, &value, 4); break; }
+        case 8: { int64_t value = values[i]; std::memcpy(dst, &value, 8); break; }
+        }
+    }
+    add(name, bytes.data(), bytes.size(), size);
+}
+
+void Blob_Writer::add_chars(const std::string &name, const std::string &text)
+{
+    add(name, text.data(), std::max<size_t>(1, text.size()), 1);
+}
+
+void Blob_Writer::add(const std::string &name, const void *data, size_t size, size_t align)
+{
+    data_.resize((data_.size() + align - 1) & ~(align - 1), '\0');
+    size_t offset = data_.size();
+    if (size > 0 && data)
+        data_.append((const char *)data, size);
+    data_.resize(offset + size, '\0');
+    symbols_.push_back(Symbol{name, offset, size});
+}
+
+void Blob_Writer::dump_stub(std::ostream &o, const std::string &blobfile) const
+{
+    std::string blob = prefix_ + "blob";
+
+    o << "#if defined(__APPLE__)" "\n";
+    o << "#define FMSYM(x) _##x" "\n";
+    o << "\t" ".const" "\n";
+    o << "#else" "\n";
+    o << "#define FMSYM(x) x" "\n";
+    o << "\t" ".section .rodata" "\n";
+    o << "#endif" "\n";
+
+    o << "\t" ".balign 16" "\n";
+    o << "FMSYM(" << blob << "):" "\n";
+    o << "\t" ".incbin \"" << blobfile << "\"" "\n";
+
+    for (const Symbol &sym : symbols_) {
+        o << "\t" ".globl FMSYM(" << prefix_ << sym.name << ")" "\n";
+        o << "\t" ".set FMSYM(" << prefix_ << sym.name << "), FMSYM(" << blob << ") + " << sym.offset << "\n";
+    }
+
+    o << "#if defined(__ELF__)" "\n";
+    for (const Symbol &sym : symbols_) {
+        o << "\t" ".type " << prefix_ << sym.name << ", %object" "\n";
+        o << "\t" ".size " << prefix_ << sym.name << ", " << sym.size << "\n";
+    }
+    o << "\t" ".section .note.GNU-stack,\"\",%progbits" "\n";
+    o << "#endif" "\n";
+}
+
+void dump_blob_table(std::ostream &o, const Blob_Writer &blob, const std::string &type, const std::string &name, size_t count)
+{
+    std::string symbol = blob.symbol(name);
+    count = std::max<size_t>(1, count);
+    o << "\t" "extern \"C\" const " << type << " " << symbol << "[" << count << "];" "\n";
+    o << "\t" "FMSTATIC constexpr const " << type << " (&" << name << ")[" << count << "] = " << symbol << ";" "\n";
+}
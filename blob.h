@@ -0,0 +1,42 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+
+// constant tables stored outside of the header, in host byte order
+//   each table is aligned to its element size, and has at least one element
+//   the blob is linked by an assembler stub which includes it by `.incbin`
+//   and defines one symbol `<prefix><name>` per table
+class Blob_Writer {
+public:
+    Blob_Writer(const std::string &prefix, unsigned float_size);
+
+    unsigned float_size() const { return float_size_; }
+    std::string symbol(const std::string &name) const { return prefix_ + name; }
+
+    void add_floats(const std::string &name, const std::vector<double> &values);
+    void add_integers(const std::string &name, const std::vector<int64_t> &values, unsigned size);
+    void add_chars(const std::string &name, const std::string &text);
+
+    const std::string &data() const { return data_; }
+    void dump_stub(std::ostream &o, const std::string &blobfile) const;
+
+private:
+    void add(const std::string &name, const void *data, size_t size, size_t align);
+
+private:
+    struct Symbol { std::string name; size_t offset; size_t size; };
+    std::string prefix_;
+    unsigned float_size_ = 0;
+    std::string data_;
+    std::vector<Symbol> symbols_;
+};
+
+// emit the declaration of a table of the blob, with a reference `name` to it
+void dump_blob_table(std::ostream &o, const Blob_Writer &blob, const std::string &type, const std::string &name, size_t count);
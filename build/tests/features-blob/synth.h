@@ -0,0 +1,714 @@
+#ifndef __mydsp_meta_H__
+#define __mydsp_meta_H__
+
+#include <cstddef>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#ifndef FAUSTMETA
+#define FAUSTMETA mydsp_meta
+#endif
+
+#ifdef __GNUC__
+#define FMSTATIC __attribute__((unused)) static
+#define FMINLINE __attribute__((unused)) static inline
+#else
+#define FMSTATIC static
+#define FMINLINE static inline
+#endif
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+namespace mydsp_meta {
+	struct metadata_t { std::uint32_t key, key_size, value, value_size; };
+	struct string_t {
+		const char *data; std::size_t size;
+		constexpr const char *c_str() const { return data; }
+#if __cplusplus >= 201703L
+		constexpr operator std::string_view() const { return std::string_view(data, size); }
+#endif
+	};
+	enum class active_type_t { button, checkbox, vslider, hslider, nentry };
+	enum class passive_type_t { vbargraph, hbargraph };
+	enum class scale_t { linear, log, exp };
+	enum class group_type_t { vgroup, hgroup, tgroup };
+	enum meta_flag_t : unsigned { meta_hidden = 1, meta_knob = 2, meta_menu = 4, meta_radio = 8, meta_led = 16, meta_numerical = 32, meta_smooth = 64, meta_midi = 128 };
+
+	FMSTATIC constexpr char name[] = u8"test synth";
+	FMSTATIC constexpr char author[] = u8"someone";
+	FMSTATIC constexpr char copyright[] = u8"(c) someone";
+	FMSTATIC constexpr char license[] = u8"BSD";
+	FMSTATIC constexpr char version[] = u8"1.0";
+	FMSTATIC constexpr char classname[] = u8"mydsp";
+	FMSTATIC constexpr unsigned inputs = 2;
+	FMSTATIC constexpr unsigned outputs = 2;
+	FMSTATIC constexpr unsigned actives = 8;
+	FMSTATIC constexpr unsigned passives = 2;
+	FMSTATIC constexpr unsigned groups = 3;
+	FMSTATIC constexpr std::uint64_t layout_fingerprint = 0xb23d95919506f04eu;
+
+	static_assert(sizeof(FAUSTFLOAT) == 4, "the blob has other FAUSTFLOAT");
+	static_assert(sizeof(int) == 4 && sizeof(unsigned) == 4, "the blob has 32-bit integers");
+
+	extern "C" const char mydsp_meta_string_pool[496];
+	FMSTATIC constexpr const char (&string_pool)[496] = mydsp_meta_string_pool;
+	FMINLINE constexpr string_t meta_key(const metadata_t &m) { return string_t{string_pool + m.key, m.key_size}; }
+	FMINLINE constexpr string_t meta_value(const metadata_t &m) { return string_t{string_pool + m.value, m.value_size}; }
+
+	FMSTATIC constexpr metadata_t metadata[] = {{347, 4, 275, 10}, {106, 6, 339, 7}};
+
+	FMINLINE std::uint64_t hash_string(const char *s, std::size_t n) { std::uint64_t h = 0xcbf29ce484222325u; for (std::size_t i = 0; i < n; ++i) { h ^= (unsigned char)s[i]; h *= 0x100000001b3u; } return h; }
+	FMINLINE std::uint32_t hash_mix(std::uint64_t key, std::uint32_t seed) { std::uint64_t h = key ^ (seed * 0x9e3779b97f4a7c15u); h ^= h >> 33; h *= 0xff51afd7ed558ccdu; h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53u; h ^= h >> 33; return (std::uint32_t)h; }
+
+	FMINLINE constexpr int meta_strcmp(const char *a, const char *b) { return (*a != *b || *a == '\0') ? ((int)(unsigned char)*a - (int)(unsigned char)*b) : meta_strcmp(a + 1, b + 1); }
+	FMINLINE constexpr unsigned meta_lower_bound(const metadata_t *m, unsigned lo, unsigned hi, const char *key) { return (lo >= hi) ? lo : (meta_strcmp(string_pool + m[lo + (hi - lo) / 2].key, key) < 0) ? meta_lower_bound(m, lo + (hi - lo) / 2 + 1, hi, key) : meta_lower_bound(m, lo, lo + (hi - lo) / 2, key); }
+	FMINLINE constexpr const char *meta_value_at(const metadata_t *m, unsigned i, unsigned hi, const char *key) { return (i < hi && meta_strcmp(string_pool + m[i].key, key) == 0) ? string_pool + m[i].value : nullptr; }
+
+	extern "C" const active_type_t mydsp_meta_active_type[8];
+	FMSTATIC constexpr const active_type_t (&active_type)[8] = mydsp_meta_active_type;
+	extern "C" const int mydsp_meta_active_id[8];
+	FMSTATIC constexpr const int (&active_id)[8] = mydsp_meta_active_id;
+	extern "C" const FAUSTFLOAT mydsp_meta_active_init[8];
+	FMSTATIC constexpr const FAUSTFLOAT (&active_init)[8] = mydsp_meta_active_init;
+	extern "C" const FAUSTFLOAT mydsp_meta_active_min[8];
+	FMSTATIC constexpr const FAUSTFLOAT (&active_min)[8] = mydsp_meta_active_min;
+	extern "C" const FAUSTFLOAT mydsp_meta_active_max[8];
+	FMSTATIC constexpr const FAUSTFLOAT (&active_max)[8] = mydsp_meta_active_max;
+	extern "C" const FAUSTFLOAT mydsp_meta_active_step[8];
+	FMSTATIC constexpr const FAUSTFLOAT (&active_step)[8] = mydsp_meta_active_step;
+	extern "C" const scale_t mydsp_meta_active_scale[8];
+	FMSTATIC constexpr const scale_t (&active_scale)[8] = mydsp_meta_active_scale;
+
+	extern "C" const std::uint32_t mydsp_meta_active_label_offset[8];
+	FMSTATIC constexpr const std::uint32_t (&active_label_offset)[8] = mydsp_meta_active_label_offset;
+	extern "C" const std::uint32_t mydsp_meta_active_label_size[8];
+	FMSTATIC constexpr const std::uint32_t (&active_label_size)[8] = mydsp_meta_active_label_size;
+	FMINLINE string_t active_label(unsigned idx) { return string_t{string_pool + active_label_offset[idx], active_label_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_active_symbol_offset[8];
+	FMSTATIC constexpr const std::uint32_t (&active_symbol_offset)[8] = mydsp_meta_active_symbol_offset;
+	extern "C" const std::uint32_t mydsp_meta_active_symbol_size[8];
+	FMSTATIC constexpr const std::uint32_t (&active_symbol_size)[8] = mydsp_meta_active_symbol_size;
+	FMINLINE string_t active_symbol(unsigned idx) { return string_t{string_pool + active_symbol_offset[idx], active_symbol_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_active_address_offset[8];
+	FMSTATIC constexpr const std::uint32_t (&active_address_offset)[8] = mydsp_meta_active_address_offset;
+	extern "C" const std::uint32_t mydsp_meta_active_address_size[8];
+	FMSTATIC constexpr const std::uint32_t (&active_address_size)[8] = mydsp_meta_active_address_size;
+	FMINLINE string_t active_address(unsigned idx) { return string_t{string_pool + active_address_offset[idx], active_address_size[idx]}; }
+	FMSTATIC const std::size_t active_offsets[] = {offsetof(FAUSTCLASS, fHslider0), offsetof(FAUSTCLASS, fHslider1), offsetof(FAUSTCLASS, fButton0), offsetof(FAUSTCLASS, fHslider3), offsetof(FAUSTCLASS, fEntry0), offsetof(FAUSTCLASS, fVslider0), offsetof(FAUSTCLASS, fHslider2), offsetof(FAUSTCLASS, fCheckbox0)};
+
+	extern "C" const std::uint32_t mydsp_meta_active_unit_offset[8];
+	FMSTATIC constexpr const std::uint32_t (&active_unit_offset)[8] = mydsp_meta_active_unit_offset;
+	extern "C" const std::uint32_t mydsp_meta_active_unit_size[8];
+	FMSTATIC constexpr const std::uint32_t (&active_unit_size)[8] = mydsp_meta_active_unit_size;
+	FMINLINE string_t active_unit(unsigned idx) { return string_t{string_pool + active_unit_offset[idx], active_unit_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_active_tooltip_offset[8];
+	FMSTATIC constexpr const std::uint32_t (&active_tooltip_offset)[8] = mydsp_meta_active_tooltip_offset;
+	extern "C" const std::uint32_t mydsp_meta_active_tooltip_size[8];
+	FMSTATIC constexpr const std::uint32_t (&active_tooltip_size)[8] = mydsp_meta_active_tooltip_size;
+	FMINLINE string_t active_tooltip(unsigned idx) { return string_t{string_pool + active_tooltip_offset[idx], active_tooltip_size[idx]}; }
+
+	FMSTATIC constexpr std::size_t active_metadata_size[] = {3, 2, 0, 1, 1, 3, 3, 1};
+
+	extern "C" const unsigned mydsp_meta_active_meta_begin[9];
+	FMSTATIC constexpr const unsigned (&active_meta_begin)[9] = mydsp_meta_active_meta_begin;
+	extern "C" const metadata_t mydsp_meta_active_meta_sorted[14];
+	FMSTATIC constexpr const metadata_t (&active_meta_sorted)[14] = mydsp_meta_active_meta_sorted;
+	extern "C" const unsigned mydsp_meta_active_flags[8];
+	FMSTATIC constexpr const unsigned (&active_flags)[8] = mydsp_meta_active_flags;
+	FMINLINE const char *active_meta(unsigned idx, const char *key) { return meta_value_at(active_meta_sorted, meta_lower_bound(active_meta_sorted, active_meta_begin[idx], active_meta_begin[idx + 1], key), active_meta_begin[idx + 1], key); }
+	FMINLINE const metadata_t *active_metadata(unsigned idx) { return active_meta_sorted + active_meta_begin[idx]; }
+
+	FMINLINE void active_set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) { *(FAUSTFLOAT *)((char *)&x + active_offsets[idx]) = v; }
+	FMINLINE FAUSTFLOAT active_get(const FAUSTCLASS &x, unsigned idx) { return *(const FAUSTFLOAT *)((const char *)&x + active_offsets[idx]); }
+
+	FMINLINE void active_set_voices(FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT v) { char *p = (char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v; }
+	FMINLINE void active_scatter_voices(FAUSTCLASS *x, unsigned n, unsigned idx, const FAUSTFLOAT *v) { char *p = (char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v[i]; }
+	FMINLINE void active_gather_voices(const FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT *v) { const char *p = (const char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) v[i] = *(const FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)); }
+
+	FMSTATIC constexpr FAUSTFLOAT active_quantum[] = {0, 0, 1, 0, 1, 0, 0, 1};
+	FMSTATIC constexpr FAUSTFLOAT active_quantum_inv[] = {0, 0, 1, 0, 1, 0, 0, 1};
+
+	FMINLINE FAUSTFLOAT active_clamp(unsigned idx, FAUSTFLOAT v) { FAUSTFLOAT lo = active_min[idx], hi = active_max[idx], q = active_quantum[idx]; v = (v > lo) ? v : lo; v = (v < hi) ? v : hi; FAUSTFLOAT s = lo + std::floor((v - lo) * active_quantum_inv[idx] + (FAUSTFLOAT)0.5) * q; s = (s < hi) ? s : hi; return (q > 0) ? s : v; }
+	FMINLINE void active_clamp_all(FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) v[i] = active_clamp(i, v[i]); }
+	FMINLINE void active_set_clamped(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) { active_set(x, idx, active_clamp(idx, v)); }
+	FMINLINE void active_set_all_clamped(FAUSTCLASS &x, const FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) active_set(x, i, active_clamp(i, v[i])); }
+
+	FMINLINE void set_freq(FAUSTCLASS &x, FAUSTFLOAT v) { x.fHslider0 = v; }
+	FMINLINE void set_gain(FAUSTCLASS &x, FAUSTFLOAT v) { x.fHslider1 = v; }
+	FMINLINE void set_gate(FAUSTCLASS &x, FAUSTFLOAT v) { x.fButton0 = v; }
+	FMINLINE void set_key(FAUSTCLASS &x, FAUSTFLOAT v) { x.fHslider3 = v; }
+	FMINLINE void set_mode(FAUSTCLASS &x, FAUSTFLOAT v) { x.fEntry0 = v; }
+	FMINLINE void set_cutoff(FAUSTCLASS &x, FAUSTFLOAT v) { x.fVslider0 = v; }
+	FMINLINE void set_reso(FAUSTCLASS &x, FAUSTFLOAT v) { x.fHslider2 = v; }
+	FMINLINE void set_bypass(FAUSTCLASS &x, FAUSTFLOAT v) { x.fCheckbox0 = v; }
+	FMINLINE FAUSTFLOAT get_freq(const FAUSTCLASS &x) { return x.fHslider0; }
+	FMINLINE FAUSTFLOAT get_gain(const FAUSTCLASS &x) { return x.fHslider1; }
+	FMINLINE FAUSTFLOAT get_gate(const FAUSTCLASS &x) { return x.fButton0; }
+	FMINLINE FAUSTFLOAT get_key(const FAUSTCLASS &x) { return x.fHslider3; }
+	FMINLINE FAUSTFLOAT get_mode(const FAUSTCLASS &x) { return x.fEntry0; }
+	FMINLINE FAUSTFLOAT get_cutoff(const FAUSTCLASS &x) { return x.fVslider0; }
+	FMINLINE FAUSTFLOAT get_reso(const FAUSTCLASS &x) { return x.fHslider2; }
+	FMINLINE FAUSTFLOAT get_bypass(const FAUSTCLASS &x) { return x.fCheckbox0; }
+
+	extern "C" const passive_type_t mydsp_meta_passive_type[2];
+	FMSTATIC constexpr const passive_type_t (&passive_type)[2] = mydsp_meta_passive_type;
+	extern "C" const int mydsp_meta_passive_id[2];
+	FMSTATIC constexpr const int (&passive_id)[2] = mydsp_meta_passive_id;
+	extern "C" const FAUSTFLOAT mydsp_meta_passive_init[2];
+	FMSTATIC constexpr const FAUSTFLOAT (&passive_init)[2] = mydsp_meta_passive_init;
+	extern "C" const FAUSTFLOAT mydsp_meta_passive_min[2];
+	FMSTATIC constexpr const FAUSTFLOAT (&passive_min)[2] = mydsp_meta_passive_min;
+	extern "C" const FAUSTFLOAT mydsp_meta_passive_max[2];
+	FMSTATIC constexpr const FAUSTFLOAT (&passive_max)[2] = mydsp_meta_passive_max;
+	extern "C" const FAUSTFLOAT mydsp_meta_passive_step[2];
+	FMSTATIC constexpr const FAUSTFLOAT (&passive_step)[2] = mydsp_meta_passive_step;
+	extern "C" const scale_t mydsp_meta_passive_scale[2];
+	FMSTATIC constexpr const scale_t (&passive_scale)[2] = mydsp_meta_passive_scale;
+
+	extern "C" const std::uint32_t mydsp_meta_passive_label_offset[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_label_offset)[2] = mydsp_meta_passive_label_offset;
+	extern "C" const std::uint32_t mydsp_meta_passive_label_size[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_label_size)[2] = mydsp_meta_passive_label_size;
+	FMINLINE string_t passive_label(unsigned idx) { return string_t{string_pool + passive_label_offset[idx], passive_label_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_passive_symbol_offset[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_symbol_offset)[2] = mydsp_meta_passive_symbol_offset;
+	extern "C" const std::uint32_t mydsp_meta_passive_symbol_size[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_symbol_size)[2] = mydsp_meta_passive_symbol_size;
+	FMINLINE string_t passive_symbol(unsigned idx) { return string_t{string_pool + passive_symbol_offset[idx], passive_symbol_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_passive_address_offset[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_address_offset)[2] = mydsp_meta_passive_address_offset;
+	extern "C" const std::uint32_t mydsp_meta_passive_address_size[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_address_size)[2] = mydsp_meta_passive_address_size;
+	FMINLINE string_t passive_address(unsigned idx) { return string_t{string_pool + passive_address_offset[idx], passive_address_size[idx]}; }
+	FMSTATIC const std::size_t passive_offsets[] = {offsetof(FAUSTCLASS, fHbargraph0), offsetof(FAUSTCLASS, fVbargraph0)};
+
+	extern "C" const std::uint32_t mydsp_meta_passive_unit_offset[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_unit_offset)[2] = mydsp_meta_passive_unit_offset;
+	extern "C" const std::uint32_t mydsp_meta_passive_unit_size[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_unit_size)[2] = mydsp_meta_passive_unit_size;
+	FMINLINE string_t passive_unit(unsigned idx) { return string_t{string_pool + passive_unit_offset[idx], passive_unit_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_passive_tooltip_offset[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_tooltip_offset)[2] = mydsp_meta_passive_tooltip_offset;
+	extern "C" const std::uint32_t mydsp_meta_passive_tooltip_size[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_tooltip_size)[2] = mydsp_meta_passive_tooltip_size;
+	FMINLINE string_t passive_tooltip(unsigned idx) { return string_t{string_pool + passive_tooltip_offset[idx], passive_tooltip_size[idx]}; }
+
+	FMSTATIC constexpr std::size_t passive_metadata_size[] = {0, 1};
+
+	extern "C" const unsigned mydsp_meta_passive_meta_begin[3];
+	FMSTATIC constexpr const unsigned (&passive_meta_begin)[3] = mydsp_meta_passive_meta_begin;
+	extern "C" const metadata_t mydsp_meta_passive_meta_sorted[1];
+	FMSTATIC constexpr const metadata_t (&passive_meta_sorted)[1] = mydsp_meta_passive_meta_sorted;
+	extern "C" const unsigned mydsp_meta_passive_flags[2];
+	FMSTATIC constexpr const unsigned (&passive_flags)[2] = mydsp_meta_passive_flags;
+	FMINLINE const char *passive_meta(unsigned idx, const char *key) { return meta_value_at(passive_meta_sorted, meta_lower_bound(passive_meta_sorted, passive_meta_begin[idx], passive_meta_begin[idx + 1], key), passive_meta_begin[idx + 1], key); }
+	FMINLINE const metadata_t *passive_metadata(unsigned idx) { return passive_meta_sorted + passive_meta_begin[idx]; }
+
+	FMINLINE FAUSTFLOAT passive_get(const FAUSTCLASS &x, unsigned idx) { return *(const FAUSTFLOAT *)((const char *)&x + passive_offsets[idx]); }
+
+	FMINLINE void passive_gather_voices(const FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT *v) { const char *p = (const char *)x + passive_offsets[idx]; for (unsigned i = 0; i < n; ++i) v[i] = *(const FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)); }
+
+	FMINLINE void passive_snapshot(const FAUSTCLASS &x, FAUSTFLOAT *out) { out[0] = x.fHbargraph0; out[1] = x.fVbargraph0; }
+
+	FMINLINE FAUSTFLOAT get_env(const FAUSTCLASS &x) { return x.fHbargraph0; }
+	FMINLINE FAUSTFLOAT get_level(const FAUSTCLASS &x) { return x.fVbargraph0; }
+
+	extern "C" const std::uint32_t mydsp_meta_active_uid[8];
+	FMSTATIC constexpr const std::uint32_t (&active_uid)[8] = mydsp_meta_active_uid;
+	FMSTATIC constexpr unsigned active_uid_buckets = 4;
+	FMSTATIC constexpr unsigned active_uid_slots = 16;
+	extern "C" const std::uint32_t mydsp_meta_active_uid_seed[4];
+	FMSTATIC constexpr const std::uint32_t (&active_uid_seed)[4] = mydsp_meta_active_uid_seed;
+	extern "C" const int mydsp_meta_active_uid_slot[16];
+	FMSTATIC constexpr const int (&active_uid_slot)[16] = mydsp_meta_active_uid_slot;
+	FMINLINE int active_index_of_uid(std::uint32_t uid) { int i = active_uid_slot[hash_mix(uid, active_uid_seed[hash_mix(uid, 0) & (active_uid_buckets - 1)]) & (active_uid_slots - 1)]; return (i >= 0 && active_uid[i] == uid) ? i : -1; }
+
+	extern "C" const std::uint32_t mydsp_meta_passive_uid[2];
+	FMSTATIC constexpr const std::uint32_t (&passive_uid)[2] = mydsp_meta_passive_uid;
+	FMSTATIC constexpr unsigned passive_uid_buckets = 1;
+	FMSTATIC constexpr unsigned passive_uid_slots = 2;
+	extern "C" const std::uint32_t mydsp_meta_passive_uid_seed[1];
+	FMSTATIC constexpr const std::uint32_t (&passive_uid_seed)[1] = mydsp_meta_passive_uid_seed;
+	extern "C" const int mydsp_meta_passive_uid_slot[2];
+	FMSTATIC constexpr const int (&passive_uid_slot)[2] = mydsp_meta_passive_uid_slot;
+	FMINLINE int passive_index_of_uid(std::uint32_t uid) { int i = passive_uid_slot[hash_mix(uid, passive_uid_seed[hash_mix(uid, 0) & (passive_uid_buckets - 1)]) & (passive_uid_slots - 1)]; return (i >= 0 && passive_uid[i] == uid) ? i : -1; }
+
+	struct zone_index_t {
+		static constexpr unsigned widgets = actives + passives;
+		static constexpr unsigned capacity = (widgets <= 8192) ? 8 * widgets + 64 : 0;
+		struct entry_t { std::size_t offset; int widget; };
+		bool direct = false;
+		std::size_t base = 0;
+		int table[capacity ? capacity : 1] = {};
+		entry_t sorted[widgets ? widgets : 1] = {};
+		zone_index_t() {
+			for (unsigned i = 0; i < actives; ++i) sorted[i] = entry_t{active_offsets[i], (int)i + 1};
+			for (unsigned i = 0; i < passives; ++i) sorted[actives + i] = entry_t{passive_offsets[i], -(int)i - 1};
+			std::sort(sorted, sorted + widgets, [](const entry_t &a, const entry_t &b) -> bool { return a.offset < b.offset; });
+			if (widgets == 0) return;
+			base = sorted[0].offset;
+			direct = (sorted[widgets - 1].offset - base) / sizeof(FAUSTFLOAT) < capacity;
+			if (direct) for (unsigned i = 0; i < widgets; ++i) table[(sorted[i].offset - base) / sizeof(FAUSTFLOAT)] = sorted[i].widget;
+		}
+		int find(std::size_t offset) const {
+			if (direct) {
+				std::size_t z = (offset - base) / sizeof(FAUSTFLOAT);
+				return (offset >= base && z < capacity && (offset - base) % sizeof(FAUSTFLOAT) == 0) ? table[z] : 0;
+			}
+			const entry_t *p = std::lower_bound(sorted, sorted + widgets, offset, [](const entry_t &e, std::size_t k) -> bool { return e.offset < k; });
+			return (p != sorted + widgets && p->offset == offset) ? p->widget : 0;
+		}
+	};
+
+	FMINLINE const zone_index_t &zone_index() { static const zone_index_t index; return index; }
+	FMINLINE int index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { return zone_index().find((std::size_t)((const char *)zone - (const char *)&x)); }
+	FMINLINE int active_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { int i = index_of_zone(x, zone); return (i > 0) ? i - 1 : -1; }
+	FMINLINE int passive_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { int i = index_of_zone(x, zone); return (i < 0) ? -i - 1 : -1; }
+
+	FMSTATIC constexpr group_type_t group_type[groups ? groups : 1] = {group_type_t::vgroup, group_type_t::hgroup, group_type_t::tgroup};
+	extern "C" const std::uint32_t mydsp_meta_group_label_offset[3];
+	FMSTATIC constexpr const std::uint32_t (&group_label_offset)[3] = mydsp_meta_group_label_offset;
+	extern "C" const std::uint32_t mydsp_meta_group_label_size[3];
+	FMSTATIC constexpr const std::uint32_t (&group_label_size)[3] = mydsp_meta_group_label_size;
+	FMINLINE string_t group_label(unsigned idx) { return string_t{string_pool + group_label_offset[idx], group_label_size[idx]}; }
+	extern "C" const std::uint32_t mydsp_meta_group_address_offset[3];
+	FMSTATIC constexpr const std::uint32_t (&group_address_offset)[3] = mydsp_meta_group_address_offset;
+	extern "C" const std::uint32_t mydsp_meta_group_address_size[3];
+	FMSTATIC constexpr const std::uint32_t (&group_address_size)[3] = mydsp_meta_group_address_size;
+	FMINLINE string_t group_address(unsigned idx) { return string_t{string_pool + group_address_offset[idx], group_address_size[idx]}; }
+	FMSTATIC constexpr int group_parent[groups ? groups : 1] = {-1, 0, 0};
+	FMSTATIC constexpr unsigned group_depth[groups ? groups : 1] = {0, 1, 1};
+	FMSTATIC constexpr unsigned group_active_begin[groups ? groups : 1] = {0, 0, 4};
+	FMSTATIC constexpr unsigned group_active_end[groups ? groups : 1] = {8, 4, 7};
+	FMSTATIC constexpr unsigned group_passive_begin[groups ? groups : 1] = {0, 0, 1};
+	FMSTATIC constexpr unsigned group_passive_end[groups ? groups : 1] = {2, 1, 2};
+
+	FMINLINE void group_reset(FAUSTCLASS &x, unsigned g) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, active_init[i]); }
+	FMINLINE void group_store(const FAUSTCLASS &x, unsigned g, FAUSTFLOAT *v) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) *v++ = active_get(x, i); }
+	FMINLINE void group_load(FAUSTCLASS &x, unsigned g, const FAUSTFLOAT *v) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, *v++); }
+
+	FMSTATIC constexpr int voice_freq = 0;
+	FMSTATIC constexpr int voice_gain = 1;
+	FMSTATIC constexpr int voice_gate = 2;
+	FMSTATIC constexpr int voice_key = 3;
+	FMSTATIC constexpr int voice_note = -1;
+	FMSTATIC constexpr int voice_vel = -1;
+
+	FMSTATIC constexpr FAUSTFLOAT midi_key_freq[128] = {8.17579892, 8.66195722, 9.177024, 9.72271824, 10.3008612, 10.9133822, 11.5623257, 12.2498574, 12.9782718, 13.75, 14.5676175, 15.4338532, 16.3515978, 17.3239144, 18.354048, 19.4454365, 20.6017223, 21.8267645, 23.1246514, 24.4997147, 25.9565436, 27.5, 29.1352351, 30.8677063, 32.7031957, 34.6478289, 36.708096, 38.890873, 41.2034446, 43.6535289, 46.2493028, 48.9994295, 51.9130872, 55, 58.2704702, 61.7354127, 65.4063913, 69.2956577, 73.416192, 77.7817459, 82.4068892, 87.3070579, 92.4986057, 97.998859, 103.826174, 110, 116.54094, 123.470825, 130.812783, 138.591315, 146.832384, 155.563492, 164.813778, 174.614116, 184.997211, 195.997718, 207.652349, 220, 233.081881, 246.941651, 261.625565, 277.182631, 293.664768, 311.126984, 329.627557, 349.228231, 369.994423, 391.995436, 415.304698, 440, 466.163762, 493.883301, 523.251131, 554.365262, 587.329536, 622.253967, 659.255114, 698.456463, 739.988845, 783.990872, 830.609395, 880, 932.327523, 987.766603, 1046.50226, 1108.73052, 1174.65907, 1244.50793, 1318.51023, 1396.91293, 1479.97769, 1567.98174, 1661.21879, 1760, 1864.65505, 1975.53321, 2093.00452, 2217.46105, 2349.31814, 2489.01587, 2637.02046, 2793.82585, 2959.95538, 3135.96349, 3322.43758, 3520, 3729.31009, 3951.06641, 4186.00904, 4434.9221, 4698.63629, 4978.03174, 5274.04091, 5587.6517, 5919.91076, 6271.92698, 6644.87516, 7040, 7458.62018, 7902.13282, 8372.01809, 8869.84419, 9397.27257, 9956.06348, 10548.0818, 11175.3034, 11839.8215, 12543.854};
+
+	FMINLINE void note_on(FAUSTCLASS &x, int key, int vel) { x.fHslider0 = midi_key_freq[key & 127]; x.fHslider1 = vel * (FAUSTFLOAT)(1.0 / 127); x.fHslider3 = (FAUSTFLOAT)key; x.fButton0 = 1; }
+	FMINLINE void note_off(FAUSTCLASS &x) { x.fButton0 = 0; }
+
+	FMSTATIC constexpr bool passive_is_db[] = {false, true};
+
+	class passive_publisher_t {
+	public:
+		void publish(const FAUSTCLASS &x) noexcept {
+			unsigned s = seq_.load(std::memory_order_relaxed);
+			seq_.store(s + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			for (unsigned i = 0; i < passives; ++i) data_[i].store(passive_get(x, i), std::memory_order_relaxed);
+			(void)x;
+			seq_.store(s + 2, std::memory_order_release);
+		}
+		bool try_read(FAUSTFLOAT *out) const noexcept {
+			unsigned s = seq_.load(std::memory_order_acquire);
+			if (s & 1) return false;
+			for (unsigned i = 0; i < passives; ++i) out[i] = data_[i].load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return seq_.load(std::memory_order_relaxed) == s;
+		}
+		void read(FAUSTFLOAT *out) const noexcept { while (!try_read(out)); }
+		unsigned frames() const noexcept { return seq_.load(std::memory_order_acquire) >> 1; }
+	private:
+		std::atomic<unsigned> seq_{0};
+		std::atomic<FAUSTFLOAT> data_[passives ? passives : 1] {};
+	};
+
+	FMINLINE void passive_peak_hold(FAUSTFLOAT *hold, const FAUSTFLOAT *in, FAUSTFLOAT fall) { for (unsigned i = 0; i < passives; ++i) { FAUSTFLOAT h = hold[i] - fall * (passive_max[i] - passive_min[i]); hold[i] = (in[i] > h) ? in[i] : h; } }
+	FMINLINE void passive_normalize(FAUSTFLOAT *out, const FAUSTFLOAT *in) { for (unsigned i = 0; i < passives; ++i) { FAUSTFLOAT r = (in[i] - passive_min[i]) / (passive_max[i] - passive_min[i]); r = (r > 0) ? r : 0; out[i] = (r < 1) ? r : 1; } }
+	FMINLINE void passive_to_db(FAUSTFLOAT *out, const FAUSTFLOAT *in, FAUSTFLOAT floor_db) { FAUSTFLOAT floor_lin = std::pow((FAUSTFLOAT)10, floor_db * (FAUSTFLOAT)0.05); for (unsigned i = 0; i < passives; ++i) { FAUSTFLOAT a = std::fabs(in[i]); a = (a > floor_lin) ? a : floor_lin; out[i] = passive_is_db[i] ? in[i] : 20 * std::log10(a); } }
+
+	FMSTATIC constexpr unsigned smooths = 2;
+	FMSTATIC constexpr unsigned smooth_index[smooths ? smooths : 1] = {0, 5};
+	FMSTATIC constexpr double smooth_time[smooths ? smooths : 1] = {0.01, 0.005};
+	FMSTATIC constexpr FAUSTFLOAT smooth_epsilon[smooths ? smooths : 1] = {0.01998, 0.00995};
+	FMSTATIC constexpr int active_smooth_slot[] = {0, -1, -1, -1, -1, 1, -1, -1};
+
+	class smoother_t {
+	public:
+		void prepare(double sample_rate, unsigned subblock) noexcept {
+			for (unsigned k = 0; k < smooths; ++k) coef_[k] = (FAUSTFLOAT)(1 - std::exp(-(double)subblock / (smooth_time[k] * sample_rate)));
+		}
+		void reset(const FAUSTCLASS &x) noexcept {
+			for (unsigned k = 0; k < smooths; ++k) current_[k] = target_[k] = active_get(x, smooth_index[k]);
+		}
+		void set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) noexcept {
+			int k = active_smooth_slot[idx];
+			if (k < 0) active_set(x, idx, v); else target_[k] = v;
+		}
+		void tick(FAUSTCLASS &x) noexcept {
+			for (unsigned k = 0; k < smooths; ++k) {
+				FAUSTFLOAT d = target_[k] - current_[k];
+				current_[k] = (std::fabs(d) > smooth_epsilon[k]) ? (current_[k] + d * coef_[k]) : target_[k];
+			}
+			for (unsigned k = 0; k < smooths; ++k) active_set(x, smooth_index[k], current_[k]);
+		}
+	private:
+		FAUSTFLOAT target_[smooths ? smooths : 1] {};
+		FAUSTFLOAT current_[smooths ? smooths : 1] {};
+		FAUSTFLOAT coef_[smooths ? smooths : 1] {};
+	};
+
+	FMINLINE unsigned dirty_ctz(std::uint64_t b) {
+	#if defined(__GNUC__)
+		return (unsigned)__builtin_ctzll(b);
+	#elif defined(_MSC_VER) && defined(_WIN64)
+		unsigned long i; _BitScanForward64(&i, b); return (unsigned)i;
+	#else
+		unsigned i = 0; while (!(b & 1)) { b >>= 1; ++i; } return i;
+	#endif
+	}
+
+	class dirty_t {
+	public:
+		static constexpr unsigned words = 1;
+		void mark(unsigned idx) noexcept { bits_[idx >> 6] |= (std::uint64_t)1 << (idx & 63); }
+		bool test(unsigned idx) const noexcept { return (bits_[idx >> 6] >> (idx & 63)) & 1; }
+		bool any() const noexcept { std::uint64_t b = 0; for (unsigned w = 0; w < words; ++w) b |= bits_[w]; return b != 0; }
+		void clear() noexcept { for (unsigned w = 0; w < words; ++w) bits_[w] = 0; }
+		template <class F> void for_each(F f) const {
+			for (unsigned w = 0; w < words; ++w)
+				for (std::uint64_t b = bits_[w]; b; b &= b - 1) f(w * 64 + dirty_ctz(b));
+		}
+		template <class F> void consume(F f) {
+			for (unsigned w = 0; w < words; ++w) {
+				std::uint64_t b = bits_[w]; bits_[w] = 0;
+				for (; b; b &= b - 1) f(w * 64 + dirty_ctz(b));
+			}
+		}
+	private:
+		std::uint64_t bits_[words] = {};
+	};
+
+	FMINLINE void active_set(FAUSTCLASS &x, dirty_t &d, unsigned idx, FAUSTFLOAT v) { active_set(x, idx, v); d.mark(idx); }
+	FMINLINE void active_set_clamped(FAUSTCLASS &x, dirty_t &d, unsigned idx, FAUSTFLOAT v) { active_set(x, idx, active_clamp(idx, v)); d.mark(idx); }
+
+	FMINLINE void set_freq(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fHslider0 = v; d.mark(0); }
+	FMINLINE void set_gain(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fHslider1 = v; d.mark(1); }
+	FMINLINE void set_gate(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fButton0 = v; d.mark(2); }
+	FMINLINE void set_key(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fHslider3 = v; d.mark(3); }
+	FMINLINE void set_mode(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fEntry0 = v; d.mark(4); }
+	FMINLINE void set_cutoff(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fVslider0 = v; d.mark(5); }
+	FMINLINE void set_reso(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fHslider2 = v; d.mark(6); }
+	FMINLINE void set_bypass(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) { x.fCheckbox0 = v; d.mark(7); }
+
+	struct param_event_t { unsigned index; FAUSTFLOAT value; };
+
+	struct drain_state_t {
+		unsigned slot[actives ? actives : 1] = {};
+		unsigned order[actives ? actives : 1];
+		FAUSTFLOAT latest[actives ? actives : 1];
+	};
+
+	template <class Queue, class Mark> FMINLINE void drain_queue(Queue &q, drain_state_t &s, FAUSTCLASS &x, Mark mark) {
+		unsigned count = 0;
+		param_event_t ev;
+		for (unsigned n = 0; n < Queue::capacity && q.pop(ev); ++n) {
+			if (ev.index >= actives) continue;
+			unsigned &slot = s.slot[ev.index];
+			if (!slot) { s.order[count] = ev.index; slot = ++count; }
+			s.latest[slot - 1] = ev.value;
+		}
+		for (unsigned i = 0; i < count; ++i) { unsigned idx = s.order[i]; s.slot[idx] = 0; active_set(x, idx, s.latest[i]); mark(idx); }
+	}
+
+	class spsc_queue_t {
+	public:
+		static constexpr unsigned capacity = 64;
+		bool push(unsigned idx, FAUSTFLOAT v) noexcept {
+			unsigned t = tail_.load(std::memory_order_relaxed);
+			if (t - head_cache_ == capacity) {
+				head_cache_ = head_.load(std::memory_order_acquire);
+				if (t - head_cache_ == capacity) return false;
+			}
+			ring_[t & (capacity - 1)] = param_event_t{idx, v};
+			tail_.store(t + 1, std::memory_order_release);
+			return true;
+		}
+		bool pop(param_event_t &ev) noexcept {
+			unsigned h = head_.load(std::memory_order_relaxed);
+			if (h == tail_cache_) {
+				tail_cache_ = tail_.load(std::memory_order_acquire);
+				if (h == tail_cache_) return false;
+			}
+			ev = ring_[h & (capacity - 1)];
+			head_.store(h + 1, std::memory_order_release);
+			return true;
+		}
+		void drain_into(FAUSTCLASS &x) noexcept { drain_queue(*this, drain_, x, [](unsigned) {}); }
+		void drain_into(FAUSTCLASS &x, dirty_t &d) noexcept { drain_queue(*this, drain_, x, [&d](unsigned i) { d.mark(i); }); }
+	private:
+		alignas(64) std::atomic<unsigned> tail_{0};
+		unsigned head_cache_ = 0;
+		alignas(64) std::atomic<unsigned> head_{0};
+		unsigned tail_cache_ = 0;
+		param_event_t ring_[capacity];
+		drain_state_t drain_;
+	};
+
+	class mpsc_queue_t {
+	public:
+		static constexpr unsigned capacity = 64;
+		mpsc_queue_t() noexcept {
+			for (unsigned i = 0; i < capacity; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+		}
+		bool push(unsigned idx, FAUSTFLOAT v) noexcept {
+			unsigned pos = tail_.load(std::memory_order_relaxed);
+			for (;;) {
+				slot_t &s = slots_[pos & (capacity - 1)];
+				int dif = (int)(s.seq.load(std::memory_order_acquire) - pos);
+				if (dif < 0) return false;
+				if (dif > 0) pos = tail_.load(std::memory_order_relaxed);
+				else if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					s.ev = param_event_t{idx, v};
+					s.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+		}
+		bool pop(param_event_t &ev) noexcept {
+			slot_t &s = slots_[head_ & (capacity - 1)];
+			if (s.seq.load(std::memory_order_acquire) != head_ + 1) return false;
+			ev = s.ev;
+			s.seq.store(head_ + capacity, std::memory_order_release);
+			++head_;
+			return true;
+		}
+		void drain_into(FAUSTCLASS &x) noexcept { drain_queue(*this, drain_, x, [](unsigned) {}); }
+		void drain_into(FAUSTCLASS &x, dirty_t &d) noexcept { drain_queue(*this, drain_, x, [&d](unsigned i) { d.mark(i); }); }
+	private:
+		struct slot_t { std::atomic<unsigned> seq; param_event_t ev; };
+		alignas(64) std::atomic<unsigned> tail_{0};
+		alignas(64) unsigned head_ = 0;
+		slot_t slots_[capacity];
+		drain_state_t drain_;
+	};
+
+	struct event_t { unsigned frame; unsigned index; FAUSTFLOAT value; };
+
+	FMINLINE void process_events(FAUSTCLASS &x, int count, FAUSTFLOAT **in, FAUSTFLOAT **out, const event_t *events, unsigned n, int min_block = 16) {
+		FAUSTFLOAT *sub_in[inputs ? inputs : 1];
+		FAUSTFLOAT *sub_out[outputs ? outputs : 1];
+		unsigned e = 0;
+		for (int pos = 0; pos < count;) {
+			for (; e < n && (int)events[e].frame <= pos; ++e)
+				if (events[e].index < actives) active_set(x, events[e].index, events[e].value);
+			int end = (e < n && (int)events[e].frame < count) ? (int)events[e].frame : count;
+			if (end - pos < min_block) end = (pos + min_block < count) ? (pos + min_block) : count;
+			for (unsigned c = 0; c < inputs; ++c) sub_in[c] = in[c] + pos;
+			for (unsigned c = 0; c < outputs; ++c) sub_out[c] = out[c] + pos;
+			x.compute(end - pos, sub_in, sub_out);
+			pos = end;
+		}
+		for (; e < n; ++e)
+			if (events[e].index < actives) active_set(x, events[e].index, events[e].value);
+	}
+
+	struct midi_map_t { unsigned index; unsigned char channel; FAUSTFLOAT scale; FAUSTFLOAT bias; };
+
+	FMSTATIC constexpr unsigned midi_ctrl_begin[129] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+	FMSTATIC constexpr midi_map_t midi_ctrl_map[2] = {{1, 0, 0.00787401572, 0}, {6, 2, 0.07795275, 0.100000001}};
+	FMSTATIC constexpr unsigned midi_keyon_begin[129] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+	FMSTATIC constexpr midi_map_t midi_keyon_map[1] = {{3, 0, 1, 0}};
+	FMSTATIC constexpr unsigned midi_keyoff_begin[129] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	FMSTATIC constexpr midi_map_t midi_keyoff_map[1] = {};
+	FMSTATIC constexpr unsigned midi_key_begin[129] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	FMSTATIC constexpr midi_map_t midi_key_map[1] = {};
+	FMSTATIC constexpr unsigned midi_keypress_begin[129] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	FMSTATIC constexpr midi_map_t midi_keypress_map[1] = {};
+	FMSTATIC constexpr unsigned midi_pitchwheel_count = 1;
+	FMSTATIC constexpr midi_map_t midi_pitchwheel_map[1] = {{5, 0, 0.607336879, 50}};
+	FMSTATIC constexpr unsigned midi_chanpress_count = 0;
+	FMSTATIC constexpr midi_map_t midi_chanpress_map[1] = {};
+	FMSTATIC constexpr unsigned midi_pgm_count = 0;
+	FMSTATIC constexpr midi_map_t midi_pgm_map[1] = {};
+
+	FMINLINE void midi_apply(FAUSTCLASS &x, const midi_map_t *m, const midi_map_t *end, unsigned ch, unsigned v) { for (; m != end; ++m) if (m->channel == 0 || m->channel == ch + 1) active_set(x, m->index, active_clamp(m->index, m->bias + (FAUSTFLOAT)v * m->scale)); }
+	FMINLINE void midi_dispatch(FAUSTCLASS &x, unsigned status, unsigned d1, unsigned d2) {
+		unsigned ch = status & 15;
+		d1 &= 127; d2 &= 127;
+		switch (status & 0xf0) {
+		case 0x80: case 0x90:
+			if ((status & 0xf0) == 0x90 && d2 != 0) {
+				midi_apply(x, midi_keyon_map + midi_keyon_begin[d1], midi_keyon_map + midi_keyon_begin[d1 + 1], ch, d2);
+				midi_apply(x, midi_key_map + midi_key_begin[d1], midi_key_map + midi_key_begin[d1 + 1], ch, d2);
+			}
+			else {
+				midi_apply(x, midi_keyoff_map + midi_keyoff_begin[d1], midi_keyoff_map + midi_keyoff_begin[d1 + 1], ch, d2);
+				midi_apply(x, midi_key_map + midi_key_begin[d1], midi_key_map + midi_key_begin[d1 + 1], ch, 0);
+			}
+			break;
+		case 0xa0:
+			midi_apply(x, midi_keypress_map + midi_keypress_begin[d1], midi_keypress_map + midi_keypress_begin[d1 + 1], ch, d2);
+			break;
+		case 0xb0:
+			midi_apply(x, midi_ctrl_map + midi_ctrl_begin[d1], midi_ctrl_map + midi_ctrl_begin[d1 + 1], ch, d2);
+			break;
+		case 0xc0:
+			midi_apply(x, midi_pgm_map, midi_pgm_map + midi_pgm_count, ch, d1);
+			break;
+		case 0xd0:
+			midi_apply(x, midi_chanpress_map, midi_chanpress_map + midi_chanpress_count, ch, d1);
+			break;
+		case 0xe0:
+			midi_apply(x, midi_pitchwheel_map, midi_pitchwheel_map + midi_pitchwheel_count, ch, d1 | (d2 << 7));
+			break;
+		}
+	}
+
+	FMSTATIC constexpr unsigned active_address_buckets = 4;
+	FMSTATIC constexpr unsigned active_address_slots = 16;
+	extern "C" const std::uint32_t mydsp_meta_active_address_seed[4];
+	FMSTATIC constexpr const std::uint32_t (&active_address_seed)[4] = mydsp_meta_active_address_seed;
+	extern "C" const int mydsp_meta_active_address_slot[16];
+	FMSTATIC constexpr const int (&active_address_slot)[16] = mydsp_meta_active_address_slot;
+
+	FMINLINE int active_index_of_address(const char *addr, std::size_t len) { std::uint64_t k = hash_string(addr, len); int i = active_address_slot[hash_mix(k, active_address_seed[hash_mix(k, 0) & (active_address_buckets - 1)]) & (active_address_slots - 1)]; return (i >= 0 && active_address_size[i] == len && !std::memcmp(string_pool + active_address_offset[i], addr, len)) ? i : -1; }
+	FMINLINE bool osc_set(FAUSTCLASS &x, const char *addr, std::size_t len, FAUSTFLOAT v) { int i = active_index_of_address(addr, len); if (i < 0) return false; active_set(x, (unsigned)i, active_clamp((unsigned)i, v)); return true; }
+
+	FMSTATIC constexpr unsigned passive_address_buckets = 1;
+	FMSTATIC constexpr unsigned passive_address_slots = 2;
+	extern "C" const std::uint32_t mydsp_meta_passive_address_seed[1];
+	FMSTATIC constexpr const std::uint32_t (&passive_address_seed)[1] = mydsp_meta_passive_address_seed;
+	extern "C" const int mydsp_meta_passive_address_slot[2];
+	FMSTATIC constexpr const int (&passive_address_slot)[2] = mydsp_meta_passive_address_slot;
+
+	FMINLINE int passive_index_of_address(const char *addr, std::size_t len) { std::uint64_t k = hash_string(addr, len); int i = passive_address_slot[hash_mix(k, passive_address_seed[hash_mix(k, 0) & (passive_address_buckets - 1)]) & (passive_address_slots - 1)]; return (i >= 0 && passive_address_size[i] == len && !std::memcmp(string_pool + passive_address_offset[i], addr, len)) ? i : -1; }
+	FMINLINE bool osc_get(const FAUSTCLASS &x, const char *addr, std::size_t len, FAUSTFLOAT &v) { int i = active_index_of_address(addr, len); if (i >= 0) { v = active_get(x, (unsigned)i); return true; } i = passive_index_of_address(addr, len); if (i >= 0) { v = passive_get(x, (unsigned)i); return true; } return false; }
+
+	struct preset_bank_header_t { char magic[4]; std::uint32_t version; std::uint64_t fingerprint; std::uint32_t actives, value_size, presets, names_size; };
+	struct preset_bank_entry_t { std::uint64_t hash; std::uint32_t preset, unused; };
+	static_assert(sizeof(preset_bank_header_t) == 32 && sizeof(preset_bank_entry_t) == 16, "the records have no padding");
+
+	FMINLINE void preset_store(const FAUSTCLASS &x, FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) v[i] = active_get(x, i); }
+	FMINLINE void preset_apply(FAUSTCLASS &x, const FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) active_set(x, i, v[i]); }
+
+	class preset_bank_t {
+	public:
+		bool open(const void *data, std::size_t size) noexcept {
+			const char *p = (const char *)data;
+			preset_bank_header_t h;
+			if (size < sizeof(h)) return false;
+			std::memcpy(&h, p, sizeof(h));
+			if (std::memcmp(h.magic, "FMPB", 4) || h.version != 1 || h.fingerprint != layout_fingerprint || h.actives != actives || h.value_size != sizeof(FAUSTFLOAT)) return false;
+			std::size_t values_size = ((std::size_t)h.presets * actives * sizeof(FAUSTFLOAT) + 7) & ~(std::size_t)7;
+			std::size_t names_size = ((std::size_t)h.presets + (h.presets & 1)) * 4;
+			std::size_t index_size = (std::size_t)h.presets * sizeof(preset_bank_entry_t);
+			if (size < sizeof(h) + values_size + names_size + index_size + h.names_size) return false;
+			presets_ = h.presets;
+			values_ = (const FAUSTFLOAT *)(p + sizeof(h));
+			names_ = (const std::uint32_t *)(p + sizeof(h) + values_size);
+			index_ = (const preset_bank_entry_t *)(p + sizeof(h) + values_size + names_size);
+			pool_ = p + sizeof(h) + values_size + names_size + index_size;
+			pool_size_ = h.names_size;
+			return pool_size_ == 0 || pool_[pool_size_ - 1] == '\0';
+		}
+		unsigned size() const noexcept { return presets_; }
+		const FAUSTFLOAT *values(unsigned i) const noexcept { return values_ + (std::size_t)i * actives; }
+		const char *name(unsigned i) const noexcept { return (i < presets_ && names_[i] < pool_size_) ? (pool_ + names_[i]) : ""; }
+		int find(const char *name, std::size_t len) const noexcept {
+			std::uint64_t k = hash_string(name, len);
+			unsigned lo = 0, hi = presets_;
+			while (lo < hi) { unsigned mid = (lo + hi) / 2; if (index_[mid].hash < k) lo = mid + 1; else hi = mid; }
+			for (; lo < presets_ && index_[lo].hash == k; ++lo) {
+				const char *n = this->name(index_[lo].preset);
+				if (!std::strncmp(n, name, len) && n[len] == '\0') return (int)index_[lo].preset;
+			}
+			return -1;
+		}
+		void apply(FAUSTCLASS &x, unsigned i) const noexcept { if (i < presets_) preset_apply(x, values(i)); }
+	private:
+		unsigned presets_ = 0;
+		const FAUSTFLOAT *values_ = nullptr;
+		const std::uint32_t *names_ = nullptr;
+		const preset_bank_entry_t *index_ = nullptr;
+		const char *pool_ = nullptr;
+		std::uint32_t pool_size_ = 0;
+	};
+
+	FMINLINE std::size_t preset_bank_write(void *dst, const FAUSTFLOAT *const *values, const char *const *names, unsigned presets) {
+		std::size_t values_size = ((std::size_t)presets * actives * sizeof(FAUSTFLOAT) + 7) & ~(std::size_t)7;
+		std::size_t names_size = ((std::size_t)presets + (presets & 1)) * 4;
+		std::size_t index_size = (std::size_t)presets * sizeof(preset_bank_entry_t);
+		std::size_t pool_size = 0;
+		for (unsigned i = 0; i < presets; ++i) pool_size += std::strlen(names[i]) + 1;
+		std::size_t size = sizeof(preset_bank_header_t) + values_size + names_size + index_size + pool_size;
+		if (!dst) return size;
+		char *p = (char *)dst;
+		std::memset(p, 0, size);
+		preset_bank_header_t h = {{'F', 'M', 'P', 'B'}, 1, layout_fingerprint, actives, sizeof(FAUSTFLOAT), presets, (std::uint32_t)pool_size};
+		std::memcpy(p, &h, sizeof(h));
+		char *pv = p + sizeof(h);
+		std::uint32_t *pn = (std::uint32_t *)(pv + values_size);
+		preset_bank_entry_t *pi = (preset_bank_entry_t *)((char *)pn + names_size);
+		char *pp = (char *)pi + index_size;
+		std::uint32_t offset = 0;
+		for (unsigned i = 0; i < presets; ++i) {
+			std::memcpy(pv + (std::size_t)i * actives * sizeof(FAUSTFLOAT), values[i], actives * sizeof(FAUSTFLOAT));
+			std::size_t len = std::strlen(names[i]);
+			std::memcpy(pp + offset, names[i], len + 1);
+			pn[i] = offset;
+			pi[i] = preset_bank_entry_t{hash_string(names[i], len), i, 0};
+			offset += (std::uint32_t)(len + 1);
+		}
+		if (presets & 1) pn[presets] = 0;
+		std::stable_sort(pi, pi + presets, [](const preset_bank_entry_t &a, const preset_bank_entry_t &b) { return a.hash < b.hash; });
+		return size;
+	}
+
+	FMSTATIC constexpr unsigned morph_linear_count = 6;
+	FMSTATIC constexpr unsigned morph_linear_index[6] = {1, 2, 3, 4, 6, 7};
+	FMSTATIC constexpr unsigned morph_log_count = 1;
+	FMSTATIC constexpr unsigned morph_log_index[1] = {0};
+	FMSTATIC constexpr unsigned morph_exp_count = 1;
+	FMSTATIC constexpr unsigned morph_exp_index[1] = {5};
+
+	FMINLINE FAUSTFLOAT morph_warp(scale_t s, unsigned i, FAUSTFLOAT v) { return (s == scale_t::log) ? std::log((v > (FAUSTFLOAT)1e-30) ? v : (FAUSTFLOAT)1e-30) : (s == scale_t::exp) ? std::exp(v - active_max[i]) : v; }
+	FMINLINE FAUSTFLOAT morph_unwarp(scale_t s, unsigned i, FAUSTFLOAT v) { return (s == scale_t::log) ? std::exp(v) : (s == scale_t::exp) ? (std::log((v > (FAUSTFLOAT)1e-30) ? v : (FAUSTFLOAT)1e-30) + active_max[i]) : v; }
+
+	template <class Out> FMINLINE void morph_each(Out out, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) {
+		for (unsigned k = 0; k < morph_linear_count; ++k) { unsigned i = morph_linear_index[k]; FAUSTFLOAT wa = morph_warp(scale_t::linear, i, a[i]), wb = morph_warp(scale_t::linear, i, b[i]); out(i, active_clamp(i, morph_unwarp(scale_t::linear, i, wa + t * (wb - wa)))); }
+		for (unsigned k = 0; k < morph_log_count; ++k) { unsigned i = morph_log_index[k]; FAUSTFLOAT wa = morph_warp(scale_t::log, i, a[i]), wb = morph_warp(scale_t::log, i, b[i]); out(i, active_clamp(i, morph_unwarp(scale_t::log, i, wa + t * (wb - wa)))); }
+		for (unsigned k = 0; k < morph_exp_count; ++k) { unsigned i = morph_exp_index[k]; FAUSTFLOAT wa = morph_warp(scale_t::exp, i, a[i]), wb = morph_warp(scale_t::exp, i, b[i]); out(i, active_clamp(i, morph_unwarp(scale_t::exp, i, wa + t * (wb - wa)))); }
+	}
+	template <class Out> FMINLINE void morph_each_n(Out out, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) {
+		FAUSTFLOAT wsum = 0;
+		for (unsigned j = 0; j < n; ++j) wsum += w[j];
+		FAUSTFLOAT winv = (wsum != 0) ? (1 / wsum) : 0;
+		for (unsigned k = 0; k < morph_linear_count; ++k) { unsigned i = morph_linear_index[k]; FAUSTFLOAT acc = 0; for (unsigned j = 0; j < n; ++j) acc += w[j] * morph_warp(scale_t::linear, i, v[j][i]); out(i, active_clamp(i, morph_unwarp(scale_t::linear, i, acc * winv))); }
+		for (unsigned k = 0; k < morph_log_count; ++k) { unsigned i = morph_log_index[k]; FAUSTFLOAT acc = 0; for (unsigned j = 0; j < n; ++j) acc += w[j] * morph_warp(scale_t::log, i, v[j][i]); out(i, active_clamp(i, morph_unwarp(scale_t::log, i, acc * winv))); }
+		for (unsigned k = 0; k < morph_exp_count; ++k) { unsigned i = morph_exp_index[k]; FAUSTFLOAT acc = 0; for (unsigned j = 0; j < n; ++j) acc += w[j] * morph_warp(scale_t::exp, i, v[j][i]); out(i, active_clamp(i, morph_unwarp(scale_t::exp, i, acc * winv))); }
+	}
+
+	FMINLINE void morph_values(FAUSTFLOAT *out, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) { morph_each([out](unsigned i, FAUSTFLOAT v) { out[i] = v; }, a, b, t); }
+	FMINLINE void morph_values_n(FAUSTFLOAT *out, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) { morph_each_n([out](unsigned i, FAUSTFLOAT r) { out[i] = r; }, v, w, n); }
+
+	FMINLINE void morph(FAUSTCLASS &x, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) { morph_each([&x](unsigned i, FAUSTFLOAT v) { active_set(x, i, v); }, a, b, t); }
+	FMINLINE void morph_n(FAUSTCLASS &x, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) { morph_each_n([&x](unsigned i, FAUSTFLOAT r) { active_set(x, i, r); }, v, w, n); }
+}
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+#undef FMSTATIC
+#undef FMINLINE
+#endif // __mydsp_meta_H__
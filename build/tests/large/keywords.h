@@ -0,0 +1,207 @@
+#ifndef __mydsp_meta_H__
+#define __mydsp_meta_H__
+
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#ifndef FAUSTMETA
+#define FAUSTMETA mydsp_meta
+#endif
+
+#ifdef __GNUC__
+#define FMSTATIC __attribute__((unused)) static
+#define FMINLINE __attribute__((unused)) static inline
+#else
+#define FMSTATIC static
+#define FMINLINE static inline
+#endif
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+
+namespace mydsp_meta {
+	struct metadata_t { const char *key; const char *value; };
+	enum class active_type_t { button, checkbox, vslider, hslider, nentry };
+	enum class passive_type_t { vbargraph, hbargraph };
+	enum class scale_t { linear, log, exp };
+	enum class group_type_t { vgroup, hgroup, tgroup };
+	enum meta_flag_t : unsigned { meta_hidden = 1, meta_knob = 2, meta_menu = 4, meta_radio = 8, meta_led = 16, meta_numerical = 32, meta_smooth = 64, meta_midi = 128 };
+
+	FMSTATIC constexpr char name[] = u8"keywords";
+	FMSTATIC constexpr char author[] = u8"";
+	FMSTATIC constexpr char copyright[] = u8"";
+	FMSTATIC constexpr char license[] = u8"";
+	FMSTATIC constexpr char version[] = u8"";
+	FMSTATIC constexpr char classname[] = u8"mydsp";
+	FMSTATIC constexpr unsigned inputs = 0;
+	FMSTATIC constexpr unsigned outputs = 1;
+	FMSTATIC constexpr unsigned actives = 4;
+	FMSTATIC constexpr unsigned passives = 1;
+	FMSTATIC constexpr unsigned groups = 2;
+	FMSTATIC constexpr std::uint64_t layout_fingerprint = 0x671004ffe9174d65u;
+
+	FMSTATIC const metadata_t metadata[] = {{u8"name", u8"keywords"}};
+
+	FMINLINE std::uint64_t hash_string(const char *s, std::size_t n) { std::uint64_t h = 0xcbf29ce484222325u; for (std::size_t i = 0; i < n; ++i) { h ^= (unsigned char)s[i]; h *= 0x100000001b3u; } return h; }
+	FMINLINE std::uint32_t hash_mix(std::uint64_t key, std::uint32_t seed) { std::uint64_t h = key ^ (seed * 0x9e3779b97f4a7c15u); h ^= h >> 33; h *= 0xff51afd7ed558ccdu; h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53u; h ^= h >> 33; return (std::uint32_t)h; }
+
+	FMINLINE constexpr int meta_strcmp(const char *a, const char *b) { return (*a != *b || *a == '\0') ? ((int)(unsigned char)*a - (int)(unsigned char)*b) : meta_strcmp(a + 1, b + 1); }
+	FMINLINE constexpr unsigned meta_lower_bound(const metadata_t *m, unsigned lo, unsigned hi, const char *key) { return (lo >= hi) ? lo : (meta_strcmp(m[lo + (hi - lo) / 2].key, key) < 0) ? meta_lower_bound(m, lo + (hi - lo) / 2 + 1, hi, key) : meta_lower_bound(m, lo, lo + (hi - lo) / 2, key); }
+	FMINLINE constexpr const char *meta_value_at(const metadata_t *m, unsigned i, unsigned hi, const char *key) { return (i < hi && meta_strcmp(m[i].key, key) == 0) ? m[i].value : nullptr; }
+
+	FMSTATIC constexpr active_type_t active_type[] = {active_type_t::checkbox, active_type_t::hslider, active_type_t::hslider, active_type_t::hslider};
+	FMSTATIC constexpr int active_id[] = {2, 3, 4, 5};
+	FMSTATIC const char *const active_label[] = {u8"switch", u8"cutoff", u8"cutoff", u8"cutoff_2"};
+	FMSTATIC const char *const active_symbol[] = {u8"switch", u8"cutoff", u8"cutoff", u8"cutoff_2"};
+	FMSTATIC const char *const active_address[] = {u8"/keywords/switch", u8"/keywords/cutoff", u8"/keywords/second/cutoff", u8"/keywords/cutoff_2"};
+	FMSTATIC const std::size_t active_offsets[] = {offsetof(FAUSTCLASS, fCheckbox0), offsetof(FAUSTCLASS, fHslider0), offsetof(FAUSTCLASS, fHslider1), offsetof(FAUSTCLASS, fHslider2)};
+	FMSTATIC constexpr FAUSTFLOAT active_init[] = {0, 1000, 2000, 3000};
+	FMSTATIC constexpr FAUSTFLOAT active_min[] = {0, 20, 20, 20};
+	FMSTATIC constexpr FAUSTFLOAT active_max[] = {1, 20000, 20000, 20000};
+	FMSTATIC constexpr FAUSTFLOAT active_step[] = {1, 1, 1, 1};
+
+	FMSTATIC const char *const active_unit[] = {u8"", u8"", u8"", u8""};
+	FMSTATIC constexpr scale_t active_scale[] = {scale_t::linear, scale_t::linear, scale_t::linear, scale_t::linear};
+	FMSTATIC const char *const active_tooltip[] = {u8"", u8"", u8"", u8""};
+
+	FMSTATIC constexpr std::size_t active_metadata_size[] = {0, 0, 0, 0};
+
+	FMSTATIC constexpr unsigned active_meta_begin[] = {0, 0, 0, 0, 0};
+	FMSTATIC constexpr metadata_t active_meta_sorted[1] = {{nullptr, nullptr}};
+	FMSTATIC constexpr unsigned active_flags[] = {0, 0, 0, 0};
+	FMINLINE constexpr const char *active_meta(unsigned idx, const char *key) { return meta_value_at(active_meta_sorted, meta_lower_bound(active_meta_sorted, active_meta_begin[idx], active_meta_begin[idx + 1], key), active_meta_begin[idx + 1], key); }
+	FMINLINE constexpr const metadata_t *active_metadata(unsigned idx) { return active_meta_sorted + active_meta_begin[idx]; }
+
+	FMINLINE void active_set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) { *(FAUSTFLOAT *)((char *)&x + active_offsets[idx]) = v; }
+	FMINLINE FAUSTFLOAT active_get(const FAUSTCLASS &x, unsigned idx) { return *(const FAUSTFLOAT *)((const char *)&x + active_offsets[idx]); }
+
+	FMINLINE void active_set_voices(FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT v) { char *p = (char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v; }
+	FMINLINE void active_scatter_voices(FAUSTCLASS *x, unsigned n, unsigned idx, const FAUSTFLOAT *v) { char *p = (char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v[i]; }
+	FMINLINE void active_gather_voices(const FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT *v) { const char *p = (const char *)x + active_offsets[idx]; for (unsigned i = 0; i < n; ++i) v[i] = *(const FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)); }
+
+	FMSTATIC constexpr FAUSTFLOAT active_quantum[] = {1, 0, 0, 0};
+	FMSTATIC constexpr FAUSTFLOAT active_quantum_inv[] = {1, 0, 0, 0};
+
+	FMINLINE FAUSTFLOAT active_clamp(unsigned idx, FAUSTFLOAT v) { FAUSTFLOAT lo = active_min[idx], hi = active_max[idx], q = active_quantum[idx]; v = (v > lo) ? v : lo; v = (v < hi) ? v : hi; FAUSTFLOAT s = lo + std::floor((v - lo) * active_quantum_inv[idx] + (FAUSTFLOAT)0.5) * q; s = (s < hi) ? s : hi; return (q > 0) ? s : v; }
+	FMINLINE void active_clamp_all(FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) v[i] = active_clamp(i, v[i]); }
+	FMINLINE void active_set_clamped(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) { active_set(x, idx, active_clamp(idx, v)); }
+	FMINLINE void active_set_all_clamped(FAUSTCLASS &x, const FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) active_set(x, i, active_clamp(i, v[i])); }
+
+	namespace active_index { enum : unsigned {
+		i_switch = 0,
+		i_cutoff_1 = 1,
+		i_cutoff_2_ = 2,
+		i_cutoff_2 = 3,
+	}; }
+
+	FMSTATIC constexpr passive_type_t passive_type[] = {passive_type_t::vbargraph};
+	FMSTATIC constexpr int passive_id[] = {6};
+	FMSTATIC const char *const passive_label[] = {u8"int"};
+	FMSTATIC const char *const passive_symbol[] = {u8"int"};
+	FMSTATIC const char *const passive_address[] = {u8"/keywords/int"};
+	FMSTATIC const std::size_t passive_offsets[] = {offsetof(FAUSTCLASS, fVbargraph0)};
+	FMSTATIC constexpr FAUSTFLOAT passive_init[] = {0};
+	FMSTATIC constexpr FAUSTFLOAT passive_min[] = {0};
+	FMSTATIC constexpr FAUSTFLOAT passive_max[] = {1};
+	FMSTATIC constexpr FAUSTFLOAT passive_step[] = {0};
+
+	FMSTATIC const char *const passive_unit[] = {u8""};
+	FMSTATIC constexpr scale_t passive_scale[] = {scale_t::linear};
+	FMSTATIC const char *const passive_tooltip[] = {u8""};
+
+	FMSTATIC constexpr std::size_t passive_metadata_size[] = {0};
+
+	FMSTATIC constexpr unsigned passive_meta_begin[] = {0, 0};
+	FMSTATIC constexpr metadata_t passive_meta_sorted[1] = {{nullptr, nullptr}};
+	FMSTATIC constexpr unsigned passive_flags[] = {0};
+	FMINLINE constexpr const char *passive_meta(unsigned idx, const char *key) { return meta_value_at(passive_meta_sorted, meta_lower_bound(passive_meta_sorted, passive_meta_begin[idx], passive_meta_begin[idx + 1], key), passive_meta_begin[idx + 1], key); }
+	FMINLINE constexpr const metadata_t *passive_metadata(unsigned idx) { return passive_meta_sorted + passive_meta_begin[idx]; }
+
+	FMINLINE FAUSTFLOAT passive_get(const FAUSTCLASS &x, unsigned idx) { return *(const FAUSTFLOAT *)((const char *)&x + passive_offsets[idx]); }
+
+	FMINLINE void passive_gather_voices(const FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT *v) { const char *p = (const char *)x + passive_offsets[idx]; for (unsigned i = 0; i < n; ++i) v[i] = *(const FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)); }
+
+	FMINLINE void passive_snapshot(const FAUSTCLASS &x, FAUSTFLOAT *out) { for (unsigned i = 0; i < passives; ++i) out[i] = passive_get(x, i); (void)x; (void)out; }
+
+	namespace passive_index { enum : unsigned {
+		i_int = 0,
+	}; }
+
+	FMSTATIC constexpr std::uint32_t active_uid[4] = {4027219231u, 3307574634u, 3075727901u, 280834727u};
+	FMSTATIC constexpr unsigned active_uid_buckets = 2;
+	FMSTATIC constexpr unsigned active_uid_slots = 8;
+	FMSTATIC constexpr std::uint32_t active_uid_seed[] = {2, 2};
+	FMSTATIC constexpr int active_uid_slot[] = {1, 3, 0, -1, -1, -1, 2, -1};
+	FMINLINE int active_index_of_uid(std::uint32_t uid) { int i = active_uid_slot[hash_mix(uid, active_uid_seed[hash_mix(uid, 0) & (active_uid_buckets - 1)]) & (active_uid_slots - 1)]; return (i >= 0 && active_uid[i] == uid) ? i : -1; }
+
+	FMSTATIC constexpr std::uint32_t passive_uid[1] = {799077264u};
+	FMSTATIC constexpr unsigned passive_uid_buckets = 1;
+	FMSTATIC constexpr unsigned passive_uid_slots = 1;
+	FMSTATIC constexpr std::uint32_t passive_uid_seed[] = {1};
+	FMSTATIC constexpr int passive_uid_slot[] = {0};
+	FMINLINE int passive_index_of_uid(std::uint32_t uid) { int i = passive_uid_slot[hash_mix(uid, passive_uid_seed[hash_mix(uid, 0) & (passive_uid_buckets - 1)]) & (passive_uid_slots - 1)]; return (i >= 0 && passive_uid[i] == uid) ? i : -1; }
+
+	struct zone_index_t {
+		static constexpr unsigned widgets = actives + passives;
+		static constexpr unsigned capacity = (widgets <= 8192) ? 8 * widgets + 64 : 0;
+		struct entry_t { std::size_t offset; int widget; };
+		bool direct = false;
+		std::size_t base = 0;
+		int table[capacity ? capacity : 1] = {};
+		entry_t sorted[widgets ? widgets : 1] = {};
+		zone_index_t() {
+			for (unsigned i = 0; i < actives; ++i) sorted[i] = entry_t{active_offsets[i], (int)i + 1};
+			for (unsigned i = 0; i < passives; ++i) sorted[actives + i] = entry_t{passive_offsets[i], -(int)i - 1};
+			std::sort(sorted, sorted + widgets, [](const entry_t &a, const entry_t &b) -> bool { return a.offset < b.offset; });
+			if (widgets == 0) return;
+			base = sorted[0].offset;
+			direct = (sorted[widgets - 1].offset - base) / sizeof(FAUSTFLOAT) < capacity;
+			if (direct) for (unsigned i = 0; i < widgets; ++i) table[(sorted[i].offset - base) / sizeof(FAUSTFLOAT)] = sorted[i].widget;
+		}
+		int find(std::size_t offset) const {
+			if (direct) {
+				std::size_t z = (offset - base) / sizeof(FAUSTFLOAT);
+				return (offset >= base && z < capacity && (offset - base) % sizeof(FAUSTFLOAT) == 0) ? table[z] : 0;
+			}
+			const entry_t *p = std::lower_bound(sorted, sorted + widgets, offset, [](const entry_t &e, std::size_t k) -> bool { return e.offset < k; });
+			return (p != sorted + widgets && p->offset == offset) ? p->widget : 0;
+		}
+	};
+
+	FMINLINE const zone_index_t &zone_index() { static const zone_index_t index; return index; }
+	FMINLINE int index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { return zone_index().find((std::size_t)((const char *)zone - (const char *)&x)); }
+	FMINLINE int active_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { int i = index_of_zone(x, zone); return (i > 0) ? i - 1 : -1; }
+	FMINLINE int passive_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) { int i = index_of_zone(x, zone); return (i < 0) ? -i - 1 : -1; }
+
+	FMSTATIC constexpr group_type_t group_type[groups ? groups : 1] = {group_type_t::vgroup, group_type_t::hgroup};
+	FMSTATIC const char *const group_label[groups ? groups : 1] = {u8"keywords", u8"second"};
+	FMSTATIC const char *const group_address[groups ? groups : 1] = {u8"/keywords", u8"/keywords/second"};
+	FMSTATIC constexpr int group_parent[groups ? groups : 1] = {-1, 0};
+	FMSTATIC constexpr unsigned group_depth[groups ? groups : 1] = {0, 1};
+	FMSTATIC constexpr unsigned group_active_begin[groups ? groups : 1] = {0, 2};
+	FMSTATIC constexpr unsigned group_active_end[groups ? groups : 1] = {4, 3};
+	FMSTATIC constexpr unsigned group_passive_begin[groups ? groups : 1] = {0, 0};
+	FMSTATIC constexpr unsigned group_passive_end[groups ? groups : 1] = {1, 0};
+
+	FMINLINE void group_reset(FAUSTCLASS &x, unsigned g) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, active_init[i]); }
+	FMINLINE void group_store(const FAUSTCLASS &x, unsigned g, FAUSTFLOAT *v) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) *v++ = active_get(x, i); }
+	FMINLINE void group_load(FAUSTCLASS &x, unsigned g, const FAUSTFLOAT *v) { for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, *v++); }
+}
+
+#define mydsp_meta_ACTIVE_WIDGETS(X) \
+	X(0, i_switch, fCheckbox0) \
+	X(1, i_cutoff_1, fHslider0) \
+	X(2, i_cutoff_2_, fHslider1) \
+	X(3, i_cutoff_2, fHslider2)
+#define mydsp_meta_PASSIVE_WIDGETS(X) \
+	X(0, i_int, fVbargraph0)
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+#undef FMSTATIC
+#undef FMINLINE
+#endif // __mydsp_meta_H__
@@ -86,6 +86,16 @@ int call_faust(const std::string &dspfile, pugi::xml_document &docmd, const Faus
     return 0;
 }
 
+unsigned faust_float_size(const Faust_Args &faustargs)
+{
+    unsigned float_size = sizeof(float);
+    for (const std::string &arg : faustargs.miscargs) {
+        if (arg == "-double")
+            float_size = sizeof(double);
+    }
+    return float_size;
+}
+
 static bool parse_cstrlit(std::string &dst, const gsl::cstring_span src)
 {
     size_t n = src.size();
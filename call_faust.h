@@ -16,3 +16,5 @@ struct Faust_Args {
 };
 
 int call_faust(const std::string &dspfile, pugi::xml_document &docmd, const Faust_Args &faustargs);
+// the size of FAUSTFLOAT in the code which faust generates with these flags
+unsigned faust_float_size(const Faust_Args &faustargs);
@@ -0,0 +1,172 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "deflate.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// bits in the order of deflate, from the least significant
+class Bit_Writer {
+public:
+    explicit Bit_Writer(std::string &out) : out_(out) {}
+
+    void put(uint32_t bits, unsigned count)
+    {
+        acc_ |= (uint64_t)bits << nbits_;
+        nbits_ += count;
+        while (nbits_ >= 8) {
+            out_.push_back((char)(acc_ & 0xff));
+            acc_ >>= 8;
+            nbits_ -= 8;
+        }
+    }
+
+    // a Huffman code, from its most significant bit
+    void put_code(uint32_t code, unsigned count)
+    {
+        uint32_t rev = 0;
+        for (unsigned i = 0; i < count; ++i)
+            rev |= ((code >> i) & 1) << (count - 1 - i);
+        put(rev, count);
+    }
+
+    void flush()
+    {
+        if (nbits_ > 0)
+            out_.push_back((char)(acc_ & 0xff));
+        acc_ = 0;
+        nbits_ = 0;
+    }
+
+private:
+    std::string &out_;
+    uint64_t acc_ = 0;
+    unsigned nbits_ = 0;
+};
+
+const unsigned length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const unsigned length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const unsigned distance_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const unsigned distance_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+void put_literal(Bit_Writer &bw, unsigned sym)
+{
+    // the fixed literal/length code
+    if (sym < 144)
+        bw.put_code(0x30 + sym, 8);
+    else if (sym < 256)
+        bw.put_code(0x190 + (sym - 144), 9);
+    else if (sym < 280)
+        bw.put_code(sym - 256, 7);
+    else
+        bw.put_code(0xc0 + (sym - 280), 8);
+}
+
+void put_match(Bit_Writer &bw, unsigned length, unsigned distance)
+{
+    unsigned l = 28;
+    while (length_base[l] > length)
+        --l;
+    put_literal(bw, 257 + l);
+    bw.put(length - length_base[l], length_extra[l]);
+
+    unsigned d = 29;
+    while (distance_base[d] > distance)
+        --d;
+    bw.put_code(d, 5);
+    bw.put(distance - distance_base[d], distance_extra[d]);
+}
+
+uint32_t adler32(const std::string &data)
+{
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : data) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+} // namespace
+
+std::string zlib_compress(const std::string &data)
+{
+    const unsigned window = 32768;
+    const unsigned min_match = 3;
+    const unsigned max_match = 258;
+    const unsigned max_chain = 64;
+    const unsigned hash_bits = 15;
+
+    std::string out;
+    out.push_back((char)0x78);
+    out.push_back((char)0x01);
+
+    Bit_Writer bw(out);
+    bw.put(1, 1); // final block
+    bw.put(1, 2); // fixed Huffman codes
+
+    const unsigned char *p = (const unsigned char *)data.data();
+    size_t n = data.size();
+
+    // the last position of each hash, and the previous one of each position
+    std::vector<int64_t> head(size_t(1) << hash_bits, -1);
+    std::vector<int64_t> prev(n, -1);
+    auto hash_at = [p](size_t i) -> uint32_t {
+        return ((p[i] << 16) | (p[i + 1] << 8) | p[i + 2]) * 2654435761u >> (32 - hash_bits);
+    };
+    auto insert = [&](size_t i) {
+        if (i + min_match <= n) {
+            uint32_t h = hash_at(i);
+            prev[i] = head[h];
+            head[h] = i;
+        }
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        unsigned best_length = 0;
+        size_t best_distance = 0;
+
+        if (i + min_match <= n) {
+            int64_t cand = head[hash_at(i)];
+            unsigned limit = (unsigned)std::min<size_t>(max_match, n - i);
+            for (unsigned chain = 0; cand != -1 && i - cand <= window && chain < max_chain; ++chain) {
+                unsigned length = 0;
+                while (length < limit && p[cand + length] == p[i + length])
+                    ++length;
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = i - cand;
+                    if (length == limit)
+                        break;
+                }
+                cand = prev[cand];
+            }
+        }
+
+        if (best_length >= min_match) {
+            put_match(bw, best_length, (unsigned)best_distance);
+            for (size_t end = i + best_length; i < end; ++i)
+                insert(i);
+        }
+        else {
+            put_literal(bw, p[i]);
+            insert(i);
+            ++i;
+        }
+    }
+
+    put_literal(bw, 256);
+    bw.flush();
+
+    uint32_t check = adler32(data);
+    for (int shift = 24; shift >= 0; shift -= 8)
+        out.push_back((char)((check >> shift) & 0xff));
+
+    return out;
+}
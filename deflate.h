@@ -0,0 +1,11 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include <string>
+
+// compress into a zlib stream (RFC 1950), readable by `uncompress` of zlib
+//   one deflate block with the fixed Huffman codes, and greedy LZ77 matching
+std::string zlib_compress(const std::string &data);
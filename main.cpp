@@ -4,6 +4,7 @@
 //          http://www.boost.org/LICENSE_1_0.txt)
 
 #include "metadata.h"
+#include "blob.h"
 #include "call_faust.h"
 #include "messages.h"
 #include "thirdparty/pugixml.hpp"
@@ -11,15 +12,20 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <fstream>
 
 struct Cmd_Args {
     std::string dspfile;
     Faust_Args faustargs;
+    Dump_Args dumpargs;
+    std::string migratefile;
+    std::string blobname;
+    std::string capifile;
 };
 
 static void display_usage();
 static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[]);
-static int process_document(std::ostream &out, const pugi::xml_document &doc);
+static int process_document(std::ostream &out, const pugi::xml_document &doc, const Cmd_Args &cmd);
 
 int main(int argc, char *argv[])
 {
@@ -35,7 +41,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    if (process_document(std::cout, doc) == -1) {
+    if (process_document(std::cout, doc, cmd) == -1) {
         errs() << "The document could not be processed.\n";
         return 1;
     }
@@ -45,7 +51,7 @@ int main(int argc, char *argv[])
 
 static void display_usage()
 {
-    std::cerr << "Usage: faustmd [-I path]* [-cn name] [-pn name] <file.dsp>\n";
+    std::cerr << "Usage: faustmd [-I path]* [-cn name] [-pn name] [-queue] [-dirty] [-snapshot] [-smooth] [-events] [-midi] [-osc] [-presets] [-morph] [-aos] [-inline] [-pool] [-large] [-xmacro] [-json] [-json-zlib] [-migrate old.dsp] [-blob name] [-capi file.h] <file.dsp>\n";
 }
 
 static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[])
@@ -79,6 +85,59 @@ static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[])
             }
             cmd.faustargs.processname = argv[i];
         }
+        else if (moreflags && arg == "-queue")
+            cmd.dumpargs.queues = true;
+        else if (moreflags && arg == "-dirty")
+            cmd.dumpargs.dirty = true;
+        else if (moreflags && arg == "-snapshot")
+            cmd.dumpargs.snapshots = true;
+        else if (moreflags && arg == "-smooth")
+            cmd.dumpargs.smoothing = true;
+        else if (moreflags && arg == "-events")
+            cmd.dumpargs.events = true;
+        else if (moreflags && arg == "-midi")
+            cmd.dumpargs.midi = true;
+        else if (moreflags && arg == "-osc")
+            cmd.dumpargs.osc = true;
+        else if (moreflags && arg == "-presets")
+            cmd.dumpargs.presets = true;
+        else if (moreflags && arg == "-morph")
+            cmd.dumpargs.morphing = true;
+        else if (moreflags && arg == "-aos")
+            cmd.dumpargs.descriptors = true;
+        else if (moreflags && arg == "-inline")
+            cmd.dumpargs.inline_definitions = true;
+        else if (moreflags && arg == "-pool")
+            cmd.dumpargs.pooled_strings = true;
+        else if (moreflags && arg == "-large")
+            cmd.dumpargs.large_ui = true;
+        else if (moreflags && arg == "-xmacro")
+            cmd.dumpargs.xmacros = true;
+        else if (moreflags && arg == "-json")
+            cmd.dumpargs.json = true;
+        else if (moreflags && arg == "-json-zlib")
+            cmd.dumpargs.json_zlib = true;
+        else if (moreflags && arg == "-migrate") {
+            if (++i == argc) {
+                errs() << "The flag `-migrate` requires an argument.\n";
+                return -1;
+            }
+            cmd.migratefile = argv[i];
+        }
+        else if (moreflags && arg == "-blob") {
+            if (++i == argc) {
+                errs() << "The flag `-blob` requires an argument.\n";
+                return -1;
+            }
+            cmd.blobname = argv[i];
+        }
+        else if (moreflags && arg == "-capi") {
+            if (++i == argc) {
+                errs() << "The flag `-capi` requires an argument.\n";
+                return -1;
+            }
+            cmd.capifile = argv[i];
+        }
         else if (moreflags && arg.subspan(0, 2) == "-X") {
             cmd.faustargs.miscargs.emplace_back(arg.begin() + 2, arg.end());
         }
@@ -107,7 +166,7 @@ static int do_cmdline(Cmd_Args &cmd, int argc, char *argv[])
     return 0;
 }
 
-static int process_document(std::ostream &out, const pugi::xml_document &doc)
+static int process_document(std::ostream &out, const pugi::xml_document &doc, const Cmd_Args &cmd)
 {
     if (false)
         doc.save(std::cerr);
@@ -118,6 +177,64 @@ static int process_document(std::ostream &out, const pugi::xml_document &doc)
         return -1;
     }
 
-    dump_metadata(out, md);
+    Dump_Args args = cmd.dumpargs;
+
+    Metadata oldmd;
+    if (!cmd.migratefile.empty()) {
+        // through faust as well, for the same workarounds on its document
+        pugi::xml_document olddoc;
+        if (call_faust(cmd.migratefile, olddoc, cmd.faustargs) == -1) {
+            errs() << "The faust command has failed on the previous version.\n";
+            return -1;
+        }
+        if (extract_metadata(olddoc, oldmd) == -1) {
+            errs() << "Could not extract the previous faust metadata.\n";
+            return -1;
+        }
+        args.migration = &oldmd;
+    }
+
+    // FAUSTFLOAT is double if faust generates double precision
+    unsigned float_size = faust_float_size(cmd.faustargs);
+
+    Blob_Writer blob(md.classname + "_meta_", float_size);
+    if (!cmd.blobname.empty())
+        args.blob = &blob;
+
+    dump_metadata(out, md, args);
+
+    if (args.blob) {
+        std::string binfile = cmd.blobname + ".bin";
+        std::string stubfile = cmd.blobname + ".S";
+
+        std::ofstream binstream(binfile, std::ios::binary);
+        binstream.write(blob.data().data(), blob.data().size());
+        binstream.flush();
+        if (!binstream) {
+            errs() << "Could not write the blob `" << binfile << "`\n";
+            return -1;
+        }
+
+        // the assembler finds the blob by its name, in the `-I` directories
+        size_t slash = binfile.rfind('/');
+        std::ofstream stubstream(stubfile);
+        blob.dump_stub(stubstream, (slash == binfile.npos) ? binfile : binfile.substr(slash + 1));
+        stubstream.flush();
+        if (!stubstream) {
+            errs() << "Could not write the blob stub `" << stubfile << "`\n";
+            return -1;
+        }
+    }
+
+    if (!cmd.capifile.empty()) {
+        std::ofstream capistream(cmd.capifile);
+        dump_capi(capistream, md, float_size);
+        capistream.flush();
+        if (!capistream) {
+            errs() << "Could not write the C interface `" << cmd.capifile << "`\n";
+            return -1;
+        }
+    }
+
     return 0;
 }
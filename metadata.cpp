@@ -4,9 +4,22 @@
 //          http://www.boost.org/LICENSE_1_0.txt)
 
 #include "metadata.h"
+#include "perfect_hash.h"
+#include "preset_bank.h"
+#include "string_pool.h"
+#include "blob.h"
+#include "deflate.h"
 #include "messages.h"
 #include <iostream>
+#include <sstream>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 #include <cassert>
 
 static const std::string cstrlit(gsl::cstring_span text);
@@ -28,7 +41,34 @@ static bool is_decint_string(gsl::cstring_span str)
     return true;
 }
 
+static bool parse_duration(gsl::cstring_span str, float &seconds)
+{
+    std::string text = gsl::to_string(str);
+    char *end;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0)
+        return false;
+
+    gsl::cstring_span suffix = gsl::cstring_span(end, text.c_str() + text.size());
+    if (suffix.empty() || suffix == "ms")
+        value *= 1e-3;
+    else if (suffix != "s")
+        return false;
+
+    seconds = (float)value;
+    return true;
+}
+
 static int extract_widget(pugi::xml_node node, bool is_active, Metadata &md);
+struct Layout_State {
+    std::map<int, std::pair<bool, unsigned>> widget_by_id;
+    std::vector<unsigned> active_order;
+    std::vector<unsigned> passive_order;
+    std::vector<std::string> path;
+};
+
+static int extract_layout(pugi::xml_node node, int parent, Layout_State &ls, Metadata &md);
+static const std::string osc_address(const std::vector<std::string> &path, const std::string &label);
 
 int extract_metadata(const pugi::xml_document &doc, Metadata &md)
 {
@@ -59,9 +99,115 @@ int extract_metadata(const pugi::xml_document &doc, Metadata &md)
             return -1;
     }
 
+    for (Metadata::Widget &w : md.active)
+        w.address = osc_address({}, w.label);
+    for (Metadata::Widget &w : md.passive)
+        w.address = osc_address({}, w.label);
+
+    Layout_State ls;
+    for (unsigned i = 0, n = md.active.size(); i < n; ++i)
+        ls.widget_by_id[md.active[i].id] = std::make_pair(true, i);
+    for (unsigned i = 0, n = md.passive.size(); i < n; ++i)
+        ls.widget_by_id[md.passive[i].id] = std::make_pair(false, i);
+
+    if (extract_layout(root.child("ui").child("layout"), -1, ls, md) == -1)
+        return -1;
+
+    // order the widgets like the layout, the unreferenced ones last
+    std::vector<unsigned> active_rest;
+    std::vector<unsigned> passive_rest;
+    for (const auto &ent : ls.widget_by_id)
+        (ent.second.first ? active_rest : passive_rest).push_back(ent.second.second);
+    std::sort(active_rest.begin(), active_rest.end());
+    std::sort(passive_rest.begin(), passive_rest.end());
+    ls.active_order.insert(ls.active_order.end(), active_rest.begin(), active_rest.end());
+    ls.passive_order.insert(ls.passive_order.end(), passive_rest.begin(), passive_rest.end());
+
+    std::vector<Metadata::Widget> active;
+    std::vector<Metadata::Widget> passive;
+    for (unsigned i : ls.active_order)
+        active.push_back(std::move(md.active[i]));
+    for (unsigned i : ls.passive_order)
+        passive.push_back(std::move(md.passive[i]));
+    md.active = std::move(active);
+    md.passive = std::move(passive);
+
+    return 0;
+}
+
+static int extract_layout(pugi::xml_node node, int parent, Layout_State &ls, Metadata &md)
+{
+    for (pugi::xml_node child : node.children()) {
+        gsl::cstring_span name = child.name();
+        if (name == "group") {
+            Metadata::Group g;
+            g.type = Metadata::Group::type_from_name(child.attribute("type").value());
+            if (g.type == (Metadata::Group::Type)-1)
+                return -1;
+            g.label = child.child_value("label");
+            g.address = osc_address(ls.path, g.label);
+            g.parent = parent;
+            g.depth = ls.path.size();
+            g.active_begin = ls.active_order.size();
+            g.passive_begin = ls.passive_order.size();
+
+            int index = md.groups.size();
+            md.groups.push_back(std::move(g));
+            if (parent != -1)
+                md.groups[parent].items.push_back({Metadata::Group::Item::Kind::Group, (unsigned)index});
+
+            ls.path.push_back(child.child_value("label"));
+            if (extract_layout(child, index, ls, md) == -1)
+                return -1;
+            ls.path.pop_back();
+
+            md.groups[index].active_end = ls.active_order.size();
+            md.groups[index].passive_end = ls.passive_order.size();
+        }
+        else if (name == "widgetref") {
+            auto it = ls.widget_by_id.find(child.attribute("id").as_int());
+            if (it == ls.widget_by_id.end()) {
+                warns() << "Unmatched widget reference `" << child.attribute("id").value() << "`\n";
+                continue;
+            }
+            bool is_active = it->second.first;
+            unsigned index = it->second.second;
+            ls.widget_by_id.erase(it);
+
+            Metadata::Widget &w = (is_active ? md.active : md.passive)[index];
+            w.address = osc_address(ls.path, w.label);
+            std::vector<unsigned> &order = is_active ? ls.active_order : ls.passive_order;
+            if (parent != -1) {
+                Metadata::Group::Item::Kind kind = is_active ? Metadata::Group::Item::Kind::Active : Metadata::Group::Item::Kind::Passive;
+                md.groups[parent].items.push_back({kind, (unsigned)order.size()});
+            }
+            order.push_back(index);
+        }
+    }
+
     return 0;
 }
 
+static const std::string osc_address(const std::vector<std::string> &path, const std::string &label)
+{
+    // like the PathBuilder of faust
+    std::string address;
+    for (size_t i = 0, n = path.size(); i < n + 1; ++i) {
+        const std::string &component = (i < n) ? path[i] : label;
+        address.push_back('/');
+        for (char c : component) {
+            switch (c) {
+            case ' ': case '#': case '*': case ',': case '/': case '?':
+            case '[': case ']': case '{': case '}': case '(': case ')':
+                c = '_';
+                break;
+            }
+            address.push_back(c);
+        }
+    }
+    return address;
+}
+
 static int extract_widget(pugi::xml_node node, bool is_active, Metadata &md)
 {
     Metadata::Widget w;
@@ -116,18 +262,88 @@ static int extract_widget(pugi::xml_node node, bool is_active, Metadata &md)
         }
         else if (key == "tooltip")
             w.tooltip = value;
-        else if (key == "md.symbol")
+        else if (key == "md.symbol") {
             w.symbol = mangle(value);
+            w.symbol_given = true;
+        }
+        else if (key == "md.smooth") {
+            if (!parse_duration(value, w.smooth))
+                warns() << "Unrecognized smoothing time `" << value << "`\n";
+        }
     }
 
     (is_active ? md.active : md.passive).push_back(std::move(w));
     return 0;
 }
 
-static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active);
+uint64_t layout_fingerprint(const Metadata &md)
+{
+    // the symbols, types, ranges and order of the widgets
+    std::string layout;
+    for (const std::vector<Metadata::Widget> *widgets : {&md.active, &md.passive}) {
+        layout.push_back((widgets == &md.active) ? 'a' : 'p');
+        for (const Metadata::Widget &w : *widgets) {
+            layout.append(w.symbol);
+            layout.push_back('\0');
+            layout.push_back((char)w.type);
+            for (float value : {w.min, w.max, w.step}) {
+                char bytes[sizeof(float)];
+                std::memcpy(bytes, &value, sizeof(float));
+                layout.append(bytes, sizeof(float));
+            }
+        }
+    }
+    return hash_string(layout);
+}
+
+static const std::string hexlit(uint64_t value)
+{
+    char text[32];
+    sprintf(text, "0x%016llxu", (unsigned long long)value);
+    return text;
+}
 
-void dump_metadata(std::ostream &o, Metadata &md)
+static std::vector<std::string> widget_names(const std::vector<Metadata::Widget> &widgets);
+static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const Dump_Args &args, const String_Pool *pool);
+static void dump_descriptors(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const String_Pool *pool);
+static void dump_widget_blob(std::ostream &o, Blob_Writer &blob, const std::vector<Metadata::Widget> &widgets, bool is_active);
+static void dump_widget_xmacro(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const std::string &ident_meta);
+static void dump_pooled_strings(std::ostream &o, const String_Pool &pool, Blob_Writer *blob, const std::string &name, const std::vector<std::string> &texts);
+static void dump_char_array(std::ostream &o, const std::string &name, gsl::cstring_span text);
+static const std::string metalit(const std::pair<std::string, std::string> &md, const String_Pool *pool);
+static void dump_meta_lookup_functions(std::ostream &o, bool pooled);
+static void dump_meta_lookup(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const String_Pool *pool, Blob_Writer *blob);
+static void dump_active_clamping(std::ostream &o, const std::vector<Metadata::Widget> &widgets);
+static void dump_uid_lookup(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, Blob_Writer *blob);
+static void dump_zone_lookup(std::ostream &o);
+static void dump_groups(std::ostream &o, const Metadata &md, const String_Pool *pool, Blob_Writer *blob);
+struct Voice_Widgets {
+    int freq, gain, gate, key, note, vel;
+    bool any() const { return freq != -1 || gain != -1 || gate != -1 || key != -1 || note != -1 || vel != -1; }
+};
+static Voice_Widgets find_voice_widgets(const Metadata &md);
+static void dump_voice_conventions(std::ostream &o, const Metadata &md, const Voice_Widgets &voice, bool large_ui);
+static void dump_passive_snapshot(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool large_ui);
+static void dump_snapshot_publisher(std::ostream &o, const Metadata &md);
+static void dump_smoothing(std::ostream &o, const Metadata &md);
+static void dump_dirty_tracking(std::ostream &o, const Metadata &md, const Dump_Args &args);
+static void dump_event_processing(std::ostream &o);
+static void dump_midi_dispatch(std::ostream &o, const Metadata &md);
+static void dump_address_dispatch(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, bool pooled, Blob_Writer *blob);
+static void dump_morphing(std::ostream &o, const Metadata &md);
+static void dump_migration(std::ostream &o, const Metadata &md, const Metadata &oldmd);
+static void dump_event_queues(std::ostream &o, const Metadata &md, const Dump_Args &args);
+static void dump_json(std::ostream &o, const Metadata &md, bool compress);
+
+void dump_metadata(std::ostream &o, Metadata &md, const Dump_Args &user_args)
 {
+    Dump_Args args = user_args;
+    if (md.active.size() + md.passive.size() >= args.large_ui_threshold)
+        args.large_ui = true;
+    // the blob has no pointers, so its strings are pooled
+    if (args.blob)
+        args.pooled_strings = true;
+
     std::string ident_classname = md.classname;
     std::string ident_meta = ident_classname + "_meta";
 
@@ -137,6 +353,18 @@ void dump_metadata(std::ostream &o, Metadata &md)
     o << "\n";
 
     o << "#include <cstddef>" "\n";
+    o << "#include <cmath>" "\n";
+    if (args.queues || args.snapshots)
+        o << "#include <atomic>" "\n";
+    o << "#include <cstdint>" "\n";
+    if (args.osc || args.presets)
+        o << "#include <cstring>" "\n";
+    o << "#include <algorithm>" "\n";
+    if (args.pooled_strings) {
+        o << "#if __cplusplus >= 201703L" "\n";
+        o << "#include <string_view>" "\n";
+        o << "#endif" "\n";
+    }
 
     o << "\n";
 
@@ -146,20 +374,72 @@ void dump_metadata(std::ostream &o, Metadata &md)
 
     o << "\n";
 
+    if (args.inline_definitions) {
+        // a single definition of each table in the program, by C++17
+        // inline variables, instead of a copy per translation unit
+        o << "#if __cplusplus < 201703L" "\n";
+        o << "#error The metadata requires C++17 inline variables" "\n";
+        o << "#endif" "\n";
+        o << "#define FMSTATIC inline" "\n";
+        o << "#define FMINLINE inline" "\n";
+    }
+    else {
+        o << "#ifdef __GNUC__" "\n";
+        o << "#define FMSTATIC __attribute__((unused)) static" "\n";
+        o << "#define FMINLINE __attribute__((unused)) static inline" "\n";
+        o << "#else" "\n";
+        o << "#define FMSTATIC static" "\n";
+        o << "#define FMINLINE static inline" "\n";
+        o << "#endif" "\n";
+    }
+
+    // the zones are located by offsetof, which is a constant expression
+    // also in the (polymorphic) dsp class, and is only warned about there
     o << "#ifdef __GNUC__" "\n";
-    o << "#define FMSTATIC __attribute__((unused)) static" "\n";
-    o << "#else" "\n";
-    o << "#define FMSTATIC static" "\n";
+    o << "#pragma GCC diagnostic push" "\n";
+    o << "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"" "\n";
     o << "#endif" "\n";
 
     o << "\n";
 
+    // all the strings in one pool, addressed without relocations
+    String_Pool pool;
+    if (args.pooled_strings) {
+        for (const std::pair<std::string, std::string> &meta : md.metadata)
+            { pool.add(meta.first); pool.add(meta.second); }
+        for (const std::vector<Metadata::Widget> *widgets : {&md.active, &md.passive}) {
+            for (const Metadata::Widget &w : *widgets) {
+                for (const std::string *text : {&w.label, &w.symbol, &w.address, &w.unit, &w.tooltip})
+                    pool.add(*text);
+                for (const std::pair<std::string, std::string> &meta : w.metadata)
+                    { pool.add(meta.first); pool.add(meta.second); }
+            }
+        }
+        for (const Metadata::Group &g : md.groups)
+            { pool.add(g.label); pool.add(g.address); }
+        pool.build();
+    }
+    const String_Pool *pooled = args.pooled_strings ? &pool : nullptr;
+
     o << "namespace " << ident_meta << " {" "\n";
 
-    o << "\t" "struct metadata_t { const char *key; const char *value; };" "\n";
+    if (!pooled)
+        o << "\t" "struct metadata_t { const char *key; const char *value; };" "\n";
+    else {
+        o << "\t" "struct metadata_t { std::uint32_t key, key_size, value, value_size; };" "\n";
+        o << "\t" "struct string_t {" "\n";
+        o << "\t\t" "const char *data; std::size_t size;" "\n";
+        o << "\t\t" "constexpr const char *c_str() const { return data; }" "\n";
+        o << "#if __cplusplus >= 201703L" "\n";
+        o << "\t\t" "constexpr operator std::string_view() const { return std::string_view(data, size); }" "\n";
+        o << "#endif" "\n";
+        o << "\t" "};" "\n";
+    }
     o << "\t" "enum class active_type_t { button, checkbox, vslider, hslider, nentry };\n";
     o << "\t" "enum class passive_type_t { vbargraph, hbargraph };\n";
     o << "\t" "enum class scale_t { linear, log, exp };\n";
+    o << "\t" "enum class group_type_t { vgroup, hgroup, tgroup };\n";
+    o << "\t" "enum meta_flag_t : unsigned { meta_hidden = 1, meta_knob = 2, meta_menu = 4, meta_radio = 8, meta_led = 16, meta_numerical = 32, meta_smooth = 64, meta_midi = 128 };\n";
 
     o << "\n";
 
@@ -173,121 +453,301 @@ void dump_metadata(std::ostream &o, Metadata &md)
     o << "\t" "FMSTATIC constexpr unsigned outputs = " << md.outputs << ";" "\n";
     o << "\t" "FMSTATIC constexpr unsigned actives = " << md.active.size() << ";" "\n";
     o << "\t" "FMSTATIC constexpr unsigned passives = " << md.passive.size() << ";" "\n";
+    o << "\t" "FMSTATIC constexpr unsigned groups = " << md.groups.size() << ";" "\n";
+    o << "\t" "FMSTATIC constexpr std::uint64_t layout_fingerprint = " << hexlit(layout_fingerprint(md)) << ";" "\n";
 
     o << "\n";
 
+    if (args.blob) {
+        // the blob is laid out for this configuration
+        o << "\t" "static_assert(sizeof(FAUSTFLOAT) == " << args.blob->float_size() << ", \"the blob has other FAUSTFLOAT\");" "\n";
+        o << "\t" "static_assert(sizeof(int) == 4 && sizeof(unsigned) == 4, \"the blob has 32-bit integers\");" "\n";
+        o << "\n";
+    }
+
+    if (args.blob) {
+        args.blob->add_chars("string_pool", pool.data());
+        dump_blob_table(o, *args.blob, "char", "string_pool", pool.data().size());
+    }
+    else if (pooled)
+        dump_char_array(o, "string_pool", pool.data());
+    if (pooled) {
+        o << "\t" "FMINLINE constexpr string_t meta_key(const metadata_t &m) { return string_t{string_pool + m.key, m.key_size}; }" "\n";
+        o << "\t" "FMINLINE constexpr string_t meta_value(const metadata_t &m) { return string_t{string_pool + m.value, m.value_size}; }" "\n";
+        o << "\n";
+    }
+
     const char *separator;
 
-    o << "\t" "FMSTATIC const metadata_t metadata[] = {";
+    o << "\t" "FMSTATIC " << (pooled ? "constexpr" : "const") << " metadata_t metadata[] = {";
     separator = "";
-    for (const std::pair<std::string, std::string> &md : md.metadata) {
-        o << separator << "{" << cstrlit(md.first) << ", " << cstrlit(md.second) << "}";
+    for (const std::pair<std::string, std::string> &meta : md.metadata) {
+        o << separator << metalit(meta, pooled);
         separator = ", ";
     }
     o << "};" "\n";
 
     o << "\n";
 
-    dump_widgets(o, md.active, true);
+    dump_hash_functions(o);
 
     o << "\n";
 
-    dump_widgets(o, md.passive, false);
+    dump_meta_lookup_functions(o, pooled);
 
-    o << "}\n";
+    o << "\n";
+
+    dump_widgets(o, md.active, true, args, pooled);
+
+    o << "\n";
+
+    dump_widgets(o, md.passive, false, args, pooled);
+
+    o << "\n";
+
+    dump_uid_lookup(o, md.active, true, args.blob);
+
+    o << "\n";
+
+    dump_uid_lookup(o, md.passive, false, args.blob);
+
+    o << "\n";
+
+    dump_zone_lookup(o);
 
     o << "\n";
 
-    o << "#undef FMSTATIC";
+    dump_groups(o, md, pooled, args.blob);
+
+    // only for the DSPs which follow the polyphonic conventions
+    Voice_Widgets voice = find_voice_widgets(md);
+    if (voice.any()) {
+        o << "\n";
+        dump_voice_conventions(o, md, voice, args.large_ui);
+    }
+
+    if (args.snapshots) {
+        o << "\n";
+        dump_snapshot_publisher(o, md);
+    }
+
+    if (args.smoothing) {
+        o << "\n";
+        dump_smoothing(o, md);
+    }
+
+    if (args.dirty) {
+        o << "\n";
+        dump_dirty_tracking(o, md, args);
+    }
+
+    if (args.queues) {
+        o << "\n";
+        dump_event_queues(o, md, args);
+    }
+
+    if (args.events) {
+        o << "\n";
+        dump_event_processing(o);
+    }
+
+    if (args.midi) {
+        o << "\n";
+        dump_midi_dispatch(o, md);
+    }
+
+    if (args.osc) {
+        o << "\n";
+        dump_address_dispatch(o, md.active, true, pooled, args.blob);
+        o << "\n";
+        dump_address_dispatch(o, md.passive, false, pooled, args.blob);
+    }
+
+    if (args.presets) {
+        o << "\n";
+        dump_preset_bank(o);
+    }
+
+    if (args.morphing) {
+        o << "\n";
+        dump_morphing(o, md);
+    }
+
+    if (args.migration) {
+        o << "\n";
+        dump_migration(o, md, *args.migration);
+    }
+
+    if (args.json || args.json_zlib) {
+        o << "\n";
+        dump_json(o, md, args.json_zlib);
+    }
+
+    o << "}\n";
 
     o << "\n";
 
+    if (args.xmacros) {
+        dump_widget_xmacro(o, md.active, true, ident_meta);
+        dump_widget_xmacro(o, md.passive, false, ident_meta);
+        o << "\n";
+    }
+
+    o << "#ifdef __GNUC__" "\n";
+    o << "#pragma GCC diagnostic pop" "\n";
+    o << "#endif" "\n";
+
+    o << "#undef FMSTATIC" "\n";
+    o << "#undef FMINLINE" "\n";
+
     o << "#endif // __" << ident_meta << "_H__" "\n";
 }
 
-static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active)
+static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const Dump_Args &args, const String_Pool *pool)
 {
     const char *separator;
     const char *prefix = is_active ? "active" : "passive";
 
-    o << "\t" "FMSTATIC constexpr " << prefix << "_type_t " << prefix << "_type[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << "" << prefix << "_type_t::" << w.type; separator = ", "; }
-    o << "};" "\n";
+    if (args.blob) {
+        dump_widget_blob(o, *args.blob, widgets, is_active);
+        o << "\n";
+    }
 
-    o << "\t" "FMSTATIC constexpr int " << prefix << "_id[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << w.id; separator = ", "; }
-    o << "};" "\n";
+    if (!args.blob) {
+        o << "\t" "FMSTATIC constexpr " << prefix << "_type_t " << prefix << "_type[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << "" << prefix << "_type_t::" << w.type; separator = ", "; }
+        o << "};" "\n";
+    }
 
-    o << "\t" "FMSTATIC const char *const " << prefix << "_label[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << cstrlit(w.label); separator = ", "; }
-    o << "};" "\n";
+    if (!args.blob) {
+        o << "\t" "FMSTATIC constexpr int " << prefix << "_id[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << w.id; separator = ", "; }
+        o << "};" "\n";
+    }
 
-    o << "\t" "FMSTATIC const char *const " << prefix << "_symbol[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << cstrlit(w.symbol); separator = ", "; }
-    o << "};" "\n";
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Widget &w : widgets)
+            texts.push_back(w.label);
+        dump_pooled_strings(o, *pool, args.blob, std::string(prefix) + "_label", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const " << prefix << "_label[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << cstrlit(w.label); separator = ", "; }
+        o << "};" "\n";
+    }
+
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Widget &w : widgets)
+            texts.push_back(w.symbol);
+        dump_pooled_strings(o, *pool, args.blob, std::string(prefix) + "_symbol", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const " << prefix << "_symbol[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << cstrlit(w.symbol); separator = ", "; }
+        o << "};" "\n";
+    }
+
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Widget &w : widgets)
+            texts.push_back(w.address);
+        dump_pooled_strings(o, *pool, args.blob, std::string(prefix) + "_address", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const " << prefix << "_address[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << cstrlit(w.address); separator = ", "; }
+        o << "};" "\n";
+    }
 
     o << "\t" "FMSTATIC const std::size_t " << prefix << "_offsets[] = {";
     separator = "";
     for (const Metadata::Widget &w : widgets)
-        { o << separator << "(size_t)&((FAUSTCLASS *)0)->" << w.var; separator = ", "; }
+        { o << separator << "offsetof(FAUSTCLASS, " << w.var << ")"; separator = ", "; }
     o << "};" "\n";
 
-    o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_init[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << w.init; separator = ", "; }
-    o << "};" "\n";
+    if (!args.blob) {
+        o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_init[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << w.init; separator = ", "; }
+        o << "};" "\n";
 
-    o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_min[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << w.min; separator = ", "; }
-    o << "};" "\n";
+        o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_min[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << w.min; separator = ", "; }
+        o << "};" "\n";
 
-    o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_max[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << w.max; separator = ", "; }
-    o << "};" "\n";
+        o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_max[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << w.max; separator = ", "; }
+        o << "};" "\n";
 
-    o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_step[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << w.step; separator = ", "; }
-    o << "};" "\n";
+        o << "\t" "FMSTATIC constexpr FAUSTFLOAT " << prefix << "_step[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << w.step; separator = ", "; }
+        o << "};" "\n";
+    }
 
     o << "\n";
 
-    o << "\t" "FMSTATIC const char *const " << prefix << "_unit[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << cstrlit(w.unit); separator = ", "; }
-    o << "};" "\n";
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Widget &w : widgets)
+            texts.push_back(w.unit);
+        dump_pooled_strings(o, *pool, args.blob, std::string(prefix) + "_unit", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const " << prefix << "_unit[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << cstrlit(w.unit); separator = ", "; }
+        o << "};" "\n";
+    }
 
-    o << "\t" "FMSTATIC constexpr scale_t " << prefix << "_scale[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << "scale_t::" << w.scale; separator = ", "; }
-    o << "};" "\n";
+    if (!args.blob) {
+        o << "\t" "FMSTATIC constexpr scale_t " << prefix << "_scale[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << "scale_t::" << w.scale; separator = ", "; }
+        o << "};" "\n";
+    }
 
-    o << "\t" "FMSTATIC const char *const " << prefix << "_tooltip[] = {";
-    separator = "";
-    for (const Metadata::Widget &w : widgets)
-        { o << separator << cstrlit(w.tooltip); separator = ", "; }
-    o << "};" "\n";
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Widget &w : widgets)
+            texts.push_back(w.tooltip);
+        dump_pooled_strings(o, *pool, args.blob, std::string(prefix) + "_tooltip", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const " << prefix << "_tooltip[] = {";
+        separator = "";
+        for (const Metadata::Widget &w : widgets)
+            { o << separator << cstrlit(w.tooltip); separator = ", "; }
+        o << "};" "\n";
+    }
 
     o << "\n";
 
+    // the flat metadata of a widget is its slice of the sorted table
+    bool flat_metadata = pool || args.large_ui;
+
     bool have_metadata = false;
-    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+    for (size_t i = 0, n = widgets.size(); i < n && !flat_metadata; ++i) {
         const Metadata::Widget &w = widgets[i];
         if (w.metadata.empty())
             continue;
@@ -304,17 +764,19 @@ static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &w
     if (have_metadata)
         o << "\n";
 
-    o << "\t" "FMSTATIC const metadata_t *const " << prefix << "_metadata[] = {";
-    separator = "";
-    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
-        const Metadata::Widget &w = widgets[i];
-        if (w.metadata.empty())
-            o << separator << "nullptr";
-        else
-            o << separator << prefix << "_metadata_" << i;
-        separator = ", ";
+    if (!flat_metadata) {
+        o << "\t" "FMSTATIC const metadata_t *const " << prefix << "_metadata[] = {";
+        separator = "";
+        for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+            const Metadata::Widget &w = widgets[i];
+            if (w.metadata.empty())
+                o << separator << "nullptr";
+            else
+                o << separator << prefix << "_metadata_" << i;
+            separator = ", ";
+        }
+        o << "};" "\n";
     }
-    o << "};" "\n";
 
     o << "\t" "FMSTATIC constexpr std::size_t " << prefix << "_metadata_size[] = {";
     separator = "";
@@ -324,67 +786,1872 @@ static void dump_widgets(std::ostream &o, const std::vector<Metadata::Widget> &w
 
     o << "\n";
 
+    dump_meta_lookup(o, widgets, is_active, pool, args.blob);
+
+    if (flat_metadata) {
+        o << "\t" "FMINLINE " << (args.blob ? "" : "constexpr ") << "const metadata_t *" << prefix << "_metadata(unsigned idx) {"
+          << " return " << prefix << "_meta_sorted + " << prefix << "_meta_begin[idx]; "
+          << "}" "\n";
+    }
+
+    o << "\n";
+
+    // with descriptors, a lookup touches the cache line of the descriptor only
+    std::string offset = std::string(prefix) + (args.descriptors ? "_desc[idx].offset" : "_offsets[idx]");
+
+    if (args.descriptors) {
+        dump_descriptors(o, widgets, is_active, pool);
+        o << "\n";
+    }
+
     if (is_active) {
-        o << "\t" "FMSTATIC inline void " << prefix << "_set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) {"
-          << " *(FAUSTFLOAT *)((char *)&x + " << prefix << "_offsets[idx]) = v; "
+        o << "\t" "FMINLINE void " << prefix << "_set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) {"
+          << " *(FAUSTFLOAT *)((char *)&x + " << offset << ") = v; "
           << "}" "\n";
     }
-    o << "\t" "FMSTATIC inline FAUSTFLOAT " << prefix << "_get(const FAUSTCLASS &x, unsigned idx) {"
-      << " return *(const FAUSTFLOAT *)((const char *)&x + " << prefix << "_offsets[idx]); "
+    o << "\t" "FMINLINE FAUSTFLOAT " << prefix << "_get(const FAUSTCLASS &x, unsigned idx) {"
+      << " return *(const FAUSTFLOAT *)((const char *)&x + " << offset << "); "
       << "}" "\n";
 
     o << "\n";
 
+    // voice banks: contiguous arrays of instances, accessed with a stride
     if (is_active) {
-        for (const Metadata::Widget &w : widgets) {
-            o << "\t" << "FMSTATIC inline void " << mangle("set_" + w.symbol) << "(FAUSTCLASS &x, FAUSTFLOAT v) {"
-              << " x." << w.var << " = v; "
+        o << "\t" "FMINLINE void " << prefix << "_set_voices(FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT v) {"
+          << " char *p = (char *)x + " << prefix << "_offsets[idx];"
+          << " for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v; "
+          << "}" "\n";
+        o << "\t" "FMINLINE void " << prefix << "_scatter_voices(FAUSTCLASS *x, unsigned n, unsigned idx, const FAUSTFLOAT *v) {"
+          << " char *p = (char *)x + " << prefix << "_offsets[idx];"
+          << " for (unsigned i = 0; i < n; ++i) *(FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)) = v[i]; "
+          << "}" "\n";
+    }
+    o << "\t" "FMINLINE void " << prefix << "_gather_voices(const FAUSTCLASS *x, unsigned n, unsigned idx, FAUSTFLOAT *v) {"
+      << " const char *p = (const char *)x + " << prefix << "_offsets[idx];"
+      << " for (unsigned i = 0; i < n; ++i) v[i] = *(const FAUSTFLOAT *)(p + i * sizeof(FAUSTCLASS)); "
+      << "}" "\n";
+
+    o << "\n";
+
+    if (is_active) {
+        dump_active_clamping(o, widgets);
+        o << "\n";
+    }
+    else {
+        dump_passive_snapshot(o, widgets, args.large_ui);
+        o << "\n";
+    }
+
+    std::vector<std::string> names = widget_names(widgets);
+
+    if (args.large_ui) {
+        // constants only, which are cheap to compile in large numbers
+        o << "\t" "namespace " << prefix << "_index { enum : unsigned {" "\n";
+        for (size_t i = 0, n = widgets.size(); i < n; ++i)
+            o << "\t\t" "i_" << names[i] << " = " << i << "," "\n";
+        o << "\t" "}; }" "\n";
+        return;
+    }
+
+    if (is_active) {
+        for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+            o << "\t" << "FMINLINE void set_" << names[i] << "(FAUSTCLASS &x, FAUSTFLOAT v) {"
+              << " x." << widgets[i].var << " = v; "
               << "}" "\n";
         }
     }
-    for (const Metadata::Widget &w : widgets) {
-        o << "\t" << "FMSTATIC inline FAUSTFLOAT " << mangle("get_" + w.symbol) << "(const FAUSTCLASS &x) {"
-          << " return x." << w.var << "; "
+    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+        o << "\t" << "FMINLINE FAUSTFLOAT get_" << names[i] << "(const FAUSTCLASS &x) {"
+          << " return x." << widgets[i].var << "; "
           << "}" "\n";
     }
 }
 
-static const std::string cstrlit(gsl::cstring_span text)
+static std::vector<std::string> widget_names(const std::vector<Metadata::Widget> &widgets)
 {
-    std::string lit;
-    lit.push_back('u');
-    lit.push_back('8');
-    lit.push_back('"');
+    // the symbols, made unique by the index where they repeat; the users
+    // prefix them, so that they are never keywords
+    std::map<std::string, unsigned> count;
+    for (const Metadata::Widget &w : widgets)
+        ++count[w.symbol];
 
-    for (char c : text) {
-        switch (c) {
-        case '\a': lit.push_back('\\'); lit.push_back('a'); break;
-        case '\b': lit.push_back('\\'); lit.push_back('b'); break;
-        case '\t': lit.push_back('\\'); lit.push_back('t'); break;
-        case '\n': lit.push_back('\\'); lit.push_back('n'); break;
-        case '\v': lit.push_back('\\'); lit.push_back('v'); break;
-        case '\f': lit.push_back('\\'); lit.push_back('f'); break;
-        case '\r': lit.push_back('\\'); lit.push_back('r'); break;
-        case '"': case '\\': lit.push_back('\\'); lit.push_back(c); break;
-        default: lit.push_back(c); break;
-        }
+    std::unordered_set<std::string> used;
+    for (const Metadata::Widget &w : widgets) {
+        if (count[w.symbol] == 1)
+            used.insert(w.symbol);
     }
 
-    lit.push_back('"');
-    return lit;
+    std::vector<std::string> names;
+    names.reserve(widgets.size());
+    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+        const std::string &symbol = widgets[i].symbol;
+        std::string name = symbol;
+        if (count[symbol] > 1) {
+            name += "_" + std::to_string(i);
+            while (!used.insert(name).second)
+                name += "_";
+        }
+        names.push_back(std::move(name));
+    }
+    return names;
 }
 
-static const std::string mangle(gsl::cstring_span name)
+static void dump_widget_blob(std::ostream &o, Blob_Writer &blob, const std::vector<Metadata::Widget> &widgets, bool is_active)
 {
-    std::string id;
-    size_t n = name.size();
-    id.reserve(n);
+    std::string prefix = is_active ? "active" : "passive";
 
-    for (size_t i = 0; i < n; ++i) {
-        char c = name[i];
-        bool al = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
-        bool num = c >= '0' && c <= '9';
-        c = (!al && (!num || i == 0)) ? '_' : c;
+    std::vector<int64_t> types, ids, scales;
+    std::vector<double> init, min, max, step;
+    for (const Metadata::Widget &w : widgets) {
+        types.push_back((int)w.type - (is_active ? 0 : (int)Metadata::Widget::Type::VBarGraph));
+        ids.push_back(w.id);
+        scales.push_back((int)w.scale);
+        init.push_back(w.init);
+        min.push_back(w.min);
+        max.push_back(w.max);
+        step.push_back(w.step);
+    }
+
+    blob.add_integers(prefix + "_type", types, 4);
+    dump_blob_table(o, blob, prefix + "_type_t", prefix + "_type", widgets.size());
+    blob.add_integers(prefix + "_id", ids, 4);
+    dump_blob_table(o, blob, "int", prefix + "_id", widgets.size());
+    blob.add_floats(prefix + "_init", init);
+    dump_blob_table(o, blob, "FAUSTFLOAT", prefix + "_init", widgets.size());
+    blob.add_floats(prefix + "_min", min);
+    dump_blob_table(o, blob, "FAUSTFLOAT", prefix + "_min", widgets.size());
+    blob.add_floats(prefix + "_max", max);
+    dump_blob_table(o, blob, "FAUSTFLOAT", prefix + "_max", widgets.size());
+    blob.add_floats(prefix + "_step", step);
+    dump_blob_table(o, blob, "FAUSTFLOAT", prefix + "_step", widgets.size());
+    blob.add_integers(prefix + "_scale", scales, 4);
+    dump_blob_table(o, blob, "scale_t", prefix + "_scale", widgets.size());
+}
+
+static void dump_widget_xmacro(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const std::string &ident_meta)
+{
+    // X(index, name, variable), to expand the widgets in user code; the name
+    // is the one of the index constant, which is a valid identifier
+    std::vector<std::string> names = widget_names(widgets);
+    o << "#define " << ident_meta << "_" << (is_active ? "ACTIVE" : "PASSIVE") << "_WIDGETS(X)";
+    for (size_t i = 0, n = widgets.size(); i < n; ++i)
+        o << " \\" "\n" "\t" "X(" << i << ", i_" << names[i] << ", " << widgets[i].var << ")";
+    o << "\n";
+}
+
+static void dump_pooled_strings(std::ostream &o, const String_Pool &pool, Blob_Writer *blob, const std::string &name, const std::vector<std::string> &texts)
+{
+    const char *separator;
+
+    if (blob) {
+        std::vector<int64_t> offsets, sizes;
+        for (const std::string &text : texts) {
+            offsets.push_back(pool.offset(text));
+            sizes.push_back(text.size());
+        }
+        blob->add_integers(name + "_offset", offsets, 4);
+        dump_blob_table(o, *blob, "std::uint32_t", name + "_offset", texts.size());
+        blob->add_integers(name + "_size", sizes, 4);
+        dump_blob_table(o, *blob, "std::uint32_t", name + "_size", texts.size());
+    }
+    else {
+        o << "\t" "FMSTATIC constexpr std::uint32_t " << name << "_offset[" << std::max<size_t>(1, texts.size()) << "] = {";
+        separator = "";
+        for (const std::string &text : texts)
+            { o << separator << pool.offset(text); separator = ", "; }
+        o << "};" "\n";
+
+        o << "\t" "FMSTATIC constexpr std::uint32_t " << name << "_size[" << std::max<size_t>(1, texts.size()) << "] = {";
+        separator = "";
+        for (const std::string &text : texts)
+            { o << separator << text.size(); separator = ", "; }
+        o << "};" "\n";
+    }
+
+    // the values of the blob are only known at link time
+    o << "\t" "FMINLINE " << (blob ? "" : "constexpr ") << "string_t " << name << "(unsigned idx) {"
+      << " return string_t{string_pool + " << name << "_offset[idx], " << name << "_size[idx]}; "
+      << "}" "\n";
+}
+
+static void dump_char_array(std::ostream &o, const std::string &name, gsl::cstring_span text)
+{
+    // characters rather than a string literal, which has a limited size with
+    // some compilers; nul-terminated like the literal
+    o << "\t" "FMSTATIC constexpr char " << name << "[] = {";
+    for (size_t i = 0, n = text.size(); i < n; ++i) {
+        if (i % 32 == 0)
+            o << "\n" "\t\t";
+        unsigned char c = text[i];
+        if (c >= 0x20 && c < 0x7f && c != '\'' && c != '\\')
+            o << '\'' << (char)c << '\'' << ",";
+        else {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "'\\x%02x'", c);
+            o << hex << ",";
+        }
+    }
+    o << "\n" "\t\t" "'\\0'" "\n" "\t" "};" "\n";
+}
+
+static const std::string metalit(const std::pair<std::string, std::string> &md, const String_Pool *pool)
+{
+    if (!pool)
+        return "{" + cstrlit(md.first) + ", " + cstrlit(md.second) + "}";
+    return "{" + std::to_string(pool->offset(md.first)) + ", " + std::to_string(md.first.size()) + ", " +
+        std::to_string(pool->offset(md.second)) + ", " + std::to_string(md.second.size()) + "}";
+}
+
+static void dump_meta_lookup_functions(std::ostream &o, bool pooled)
+{
+    // pooled keys and values are offsets in the string pool
+    const char *base = pooled ? "string_pool + " : "";
+
+    // C++11 constexpr, evaluable at compile time
+    o << "\t" "FMINLINE constexpr int meta_strcmp(const char *a, const char *b) {"
+      << " return (*a != *b || *a == '\\0') ? ((int)(unsigned char)*a - (int)(unsigned char)*b) : meta_strcmp(a + 1, b + 1); "
+      << "}" "\n";
+    o << "\t" "FMINLINE constexpr unsigned meta_lower_bound(const metadata_t *m, unsigned lo, unsigned hi, const char *key) {"
+      << " return (lo >= hi) ? lo : (meta_strcmp(" << base << "m[lo + (hi - lo) / 2].key, key) < 0) ?"
+      << " meta_lower_bound(m, lo + (hi - lo) / 2 + 1, hi, key) : meta_lower_bound(m, lo, lo + (hi - lo) / 2, key); "
+      << "}" "\n";
+    o << "\t" "FMINLINE constexpr const char *meta_value_at(const metadata_t *m, unsigned i, unsigned hi, const char *key) {"
+      << " return (i < hi && meta_strcmp(" << base << "m[i].key, key) == 0) ? " << base << "m[i].value : nullptr; "
+      << "}" "\n";
+}
+
+static unsigned widget_meta_flags(const Metadata::Widget &w)
+{
+    unsigned flags = 0;
+    for (const std::pair<std::string, std::string> &meta : w.metadata) {
+        const std::string &key = meta.first;
+        const std::string &value = meta.second;
+        if (key == "hidden" && value != "0")
+            flags |= 1;
+        else if (key == "style") {
+            if (value == "knob")
+                flags |= 2;
+            else if (value.compare(0, 4, "menu") == 0)
+                flags |= 4;
+            else if (value.compare(0, 5, "radio") == 0)
+                flags |= 8;
+            else if (value == "led")
+                flags |= 16;
+            else if (value == "numerical")
+                flags |= 32;
+        }
+        else if (key == "md.smooth")
+            flags |= 64;
+        else if (key == "midi")
+            flags |= 128;
+    }
+    return flags;
+}
+
+static void dump_meta_lookup(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const String_Pool *pool, Blob_Writer *blob)
+{
+    const char *prefix = is_active ? "active" : "passive";
+    const char *separator;
+
+    // the metadata of all the widgets, sorted by key within each widget
+    std::vector<int64_t> begin;
+    std::vector<std::pair<std::string, std::string>> all;
+    for (const Metadata::Widget &w : widgets) {
+        begin.push_back(all.size());
+        std::vector<std::pair<std::string, std::string>> sorted = w.metadata;
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const std::pair<std::string, std::string> &a, const std::pair<std::string, std::string> &b) -> bool {
+                             return a.first < b.first; });
+        all.insert(all.end(), sorted.begin(), sorted.end());
+    }
+    begin.push_back(all.size());
+
+    std::vector<int64_t> flags;
+    for (const Metadata::Widget &w : widgets)
+        flags.push_back(widget_meta_flags(w));
+
+    if (blob) {
+        // the pooled entries, as 4 integers each
+        std::vector<int64_t> entries;
+        for (const std::pair<std::string, std::string> &md : all) {
+            entries.push_back(pool->offset(md.first));
+            entries.push_back(md.first.size());
+            entries.push_back(pool->offset(md.second));
+            entries.push_back(md.second.size());
+        }
+        blob->add_integers(std::string(prefix) + "_meta_begin", begin, 4);
+        dump_blob_table(o, *blob, "unsigned", std::string(prefix) + "_meta_begin", begin.size());
+        blob->add_integers(std::string(prefix) + "_meta_sorted", entries, 4);
+        dump_blob_table(o, *blob, "metadata_t", std::string(prefix) + "_meta_sorted", all.size());
+        blob->add_integers(std::string(prefix) + "_flags", flags, 4);
+        dump_blob_table(o, *blob, "unsigned", std::string(prefix) + "_flags", flags.size());
+    }
+    else {
+        o << "\t" "FMSTATIC constexpr unsigned " << prefix << "_meta_begin[] = {";
+        separator = "";
+        for (int64_t index : begin)
+            { o << separator << index; separator = ", "; }
+        o << "};" "\n";
+
+        o << "\t" "FMSTATIC constexpr metadata_t " << prefix << "_meta_sorted[" << std::max<size_t>(1, all.size()) << "] = {";
+        separator = "";
+        for (const std::pair<std::string, std::string> &md : all)
+            { o << separator << metalit(md, pool); separator = ", "; }
+        if (all.empty())
+            o << (pool ? "{0, 0, 0, 0}" : "{nullptr, nullptr}");
+        o << "};" "\n";
+
+        o << "\t" "FMSTATIC constexpr unsigned " << prefix << "_flags[] = {";
+        separator = "";
+        for (int64_t flag : flags)
+            { o << separator << flag; separator = ", "; }
+        o << "};" "\n";
+    }
+
+    o << "\t" "FMINLINE " << (blob ? "" : "constexpr ") << "const char *" << prefix << "_meta(unsigned idx, const char *key) {"
+      << " return meta_value_at(" << prefix << "_meta_sorted, meta_lower_bound(" << prefix << "_meta_sorted, " << prefix << "_meta_begin[idx], " << prefix << "_meta_begin[idx + 1], key), " << prefix << "_meta_begin[idx + 1], key); "
+      << "}" "\n";
+}
+
+static void dump_descriptors(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, const String_Pool *pool)
+{
+    const char *prefix = is_active ? "active" : "passive";
+    const char *separator;
+
+    // the strings are in the common pool if there is one, else in their own
+    String_Pool own_pool;
+    if (!pool) {
+        for (const Metadata::Widget &w : widgets) {
+            own_pool.add(w.label);
+            own_pool.add(w.symbol);
+        }
+        own_pool.build();
+        pool = &own_pool;
+    }
+
+    // one record per widget, of 32 bytes with float or 64 bytes with double
+    o << "\t" "struct alignas(sizeof(FAUSTFLOAT) == 4 ? 32 : 64) " << prefix << "_desc_t {"
+      << " std::uint32_t offset; std::uint8_t type, scale; std::uint16_t flags;"
+      << " FAUSTFLOAT init, min, max, step;"
+      << " std::uint32_t label, symbol; "
+      << "};" "\n";
+    o << "\t" "static_assert(sizeof(" << prefix << "_desc_t) == (sizeof(FAUSTFLOAT) == 4 ? 32 : 64), \"unexpected descriptor size\");" "\n";
+
+    if (pool == &own_pool)
+        dump_char_array(o, std::string(prefix) + "_desc_strings", pool->data());
+
+    o << "\t" "FMSTATIC const " << prefix << "_desc_t " << prefix << "_desc[" << std::max<size_t>(1, widgets.size()) << "] = {";
+    separator = "";
+    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+        const Metadata::Widget &w = widgets[i];
+        unsigned type = (unsigned)w.type - (is_active ? 0 : (unsigned)Metadata::Widget::Type::VBarGraph);
+        o << separator << "{"
+          << "(std::uint32_t)offsetof(FAUSTCLASS, " << w.var << "), "
+          << type << ", " << (unsigned)w.scale << ", " << widget_meta_flags(w) << ", "
+          << w.init << ", " << w.min << ", " << w.max << ", " << w.step << ", "
+          << pool->offset(w.label) << ", " << pool->offset(w.symbol) << "}";
+        separator = ", ";
+    }
+    o << "};" "\n";
+
+    std::string strings = (pool == &own_pool) ? std::string(prefix) + "_desc_strings" : std::string("string_pool");
+    o << "\t" "FMINLINE const char *" << prefix << "_desc_string(std::uint32_t offset) { return " << strings << " + offset; }" "\n";
+}
+
+static bool is_discrete_widget(const Metadata::Widget &w)
+{
+    return w.type == Metadata::Widget::Type::Button ||
+        w.type == Metadata::Widget::Type::CheckBox ||
+        w.type == Metadata::Widget::Type::NEntry;
+}
+
+static void dump_active_clamping(std::ostream &o, const std::vector<Metadata::Widget> &widgets)
+{
+    const char *separator;
+
+    // the quantum is the step of discrete widgets, zero if the value is continuous
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT active_quantum[] = {";
+    separator = "";
+    for (const Metadata::Widget &w : widgets) {
+        float q = (is_discrete_widget(w) && w.step > 0) ? w.step : 0;
+        o << separator << q;
+        separator = ", ";
+    }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT active_quantum_inv[] = {";
+    separator = "";
+    for (const Metadata::Widget &w : widgets) {
+        float q = (is_discrete_widget(w) && w.step > 0) ? w.step : 0;
+        o << separator << ((q > 0) ? (1 / q) : 0);
+        separator = ", ";
+    }
+    o << "};" "\n";
+
+    o << "\n";
+
+    // the computation is branch-free, and maps NaN to the minimum
+    o << "\t" "FMINLINE FAUSTFLOAT active_clamp(unsigned idx, FAUSTFLOAT v) {"
+      << " FAUSTFLOAT lo = active_min[idx], hi = active_max[idx], q = active_quantum[idx];"
+      << " v = (v > lo) ? v : lo; v = (v < hi) ? v : hi;"
+      << " FAUSTFLOAT s = lo + std::floor((v - lo) * active_quantum_inv[idx] + (FAUSTFLOAT)0.5) * q;"
+      << " s = (s < hi) ? s : hi;"
+      << " return (q > 0) ? s : v; "
+      << "}" "\n";
+    o << "\t" "FMINLINE void active_clamp_all(FAUSTFLOAT *v) {"
+      << " for (unsigned i = 0; i < actives; ++i) v[i] = active_clamp(i, v[i]); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void active_set_clamped(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) {"
+      << " active_set(x, idx, active_clamp(idx, v)); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void active_set_all_clamped(FAUSTCLASS &x, const FAUSTFLOAT *v) {"
+      << " for (unsigned i = 0; i < actives; ++i) active_set(x, i, active_clamp(i, v[i])); "
+      << "}" "\n";
+}
+
+static unsigned next_power_of_two(unsigned n)
+{
+    unsigned p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+static std::vector<uint32_t> widget_uids(const std::vector<Metadata::Widget> &widgets, bool warn = true)
+{
+    // hashed from the symbol given by the author, which survives renaming
+    // and moving; otherwise from the full address, which depends on this
+    // widget alone, unlike a symbol derived from the label which may repeat
+    std::unordered_set<uint32_t> uids;
+    std::vector<uint32_t> result;
+    for (const Metadata::Widget &w : widgets) {
+        uint32_t uid = (uint32_t)hash_string(w.symbol_given ? w.symbol : w.address);
+        if (!uids.insert(uid).second && warn)
+            warns() << "Identifier collision for `" << w.address << "`\n";
+        result.push_back(uid);
+    }
+    return result;
+}
+
+static void dump_uid_lookup(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, Blob_Writer *blob)
+{
+    const char *prefix = is_active ? "active" : "passive";
+    const char *separator;
+
+    std::vector<uint32_t> uids = widget_uids(widgets);
+
+    if (blob) {
+        blob->add_integers(std::string(prefix) + "_uid", std::vector<int64_t>(uids.begin(), uids.end()), 4);
+        dump_blob_table(o, *blob, "std::uint32_t", std::string(prefix) + "_uid", uids.size());
+    }
+    else {
+        o << "\t" "FMSTATIC constexpr std::uint32_t " << prefix << "_uid[" << std::max<size_t>(1, uids.size()) << "] = {";
+        separator = "";
+        for (uint32_t uid : uids)
+            { o << separator << uid << "u"; separator = ", "; }
+        o << "};" "\n";
+    }
+
+    // on collision, only the first widget can be found
+    std::vector<uint64_t> keys;
+    std::vector<unsigned> key_widget;
+    std::unordered_set<uint64_t> seen;
+    for (size_t i = 0, n = uids.size(); i < n; ++i) {
+        if (seen.insert(uids[i]).second) {
+            keys.push_back(uids[i]);
+            key_widget.push_back(i);
+        }
+    }
+
+    Perfect_Hash ph;
+    if (!build_perfect_hash(keys, ph)) {
+        errs() << "Could not build the perfect hash of identifiers\n";
+        ph.buckets = ph.slots = 1;
+        ph.seeds.assign(1, 0);
+        ph.slot_key.assign(1, -1);
+    }
+    for (int &key : ph.slot_key) {
+        if (key != -1)
+            key = key_widget[key];
+    }
+
+    dump_perfect_hash(o, ph, std::string(prefix) + "_uid", blob);
+
+    o << "\t" "FMINLINE int " << prefix << "_index_of_uid(std::uint32_t uid) {"
+      << " int i = " << prefix << "_uid_slot[hash_mix(uid, " << prefix << "_uid_seed[hash_mix(uid, 0) & (" << prefix << "_uid_buckets - 1)]) & (" << prefix << "_uid_slots - 1)];"
+      << " return (i >= 0 && " << prefix << "_uid[i] == uid) ? i : -1; "
+      << "}" "\n";
+}
+
+static void dump_zone_lookup(std::ostream &o)
+{
+    // the offsets are known at run time only, so the index is built on first
+    // use: a direct table if the zones span few enough FAUSTFLOAT, otherwise
+    // a binary search of the sorted offsets; the table has a bounded size,
+    // and the large UIs use the search only
+    //   widgets are encoded as i + 1 for active i, -(j + 1) for passive j
+    o << "\t" "struct zone_index_t {" "\n";
+    o << "\t\t" "static constexpr unsigned widgets = actives + passives;" "\n";
+    o << "\t\t" "static constexpr unsigned capacity = (widgets <= 8192) ? 8 * widgets + 64 : 0;" "\n";
+    o << "\t\t" "struct entry_t { std::size_t offset; int widget; };" "\n";
+    o << "\t\t" "bool direct = false;" "\n";
+    o << "\t\t" "std::size_t base = 0;" "\n";
+    o << "\t\t" "int table[capacity ? capacity : 1] = {};" "\n";
+    o << "\t\t" "entry_t sorted[widgets ? widgets : 1] = {};" "\n";
+    o << "\t\t" "zone_index_t() {" "\n";
+    o << "\t\t\t" "for (unsigned i = 0; i < actives; ++i) sorted[i] = entry_t{active_offsets[i], (int)i + 1};" "\n";
+    o << "\t\t\t" "for (unsigned i = 0; i < passives; ++i) sorted[actives + i] = entry_t{passive_offsets[i], -(int)i - 1};" "\n";
+    o << "\t\t\t" "std::sort(sorted, sorted + widgets, [](const entry_t &a, const entry_t &b) -> bool { return a.offset < b.offset; });" "\n";
+    o << "\t\t\t" "if (widgets == 0) return;" "\n";
+    o << "\t\t\t" "base = sorted[0].offset;" "\n";
+    o << "\t\t\t" "direct = (sorted[widgets - 1].offset - base) / sizeof(FAUSTFLOAT) < capacity;" "\n";
+    o << "\t\t\t" "if (direct) for (unsigned i = 0; i < widgets; ++i) table[(sorted[i].offset - base) / sizeof(FAUSTFLOAT)] = sorted[i].widget;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "int find(std::size_t offset) const {" "\n";
+    o << "\t\t\t" "if (direct) {" "\n";
+    o << "\t\t\t\t" "std::size_t z = (offset - base) / sizeof(FAUSTFLOAT);" "\n";
+    o << "\t\t\t\t" "return (offset >= base && z < capacity && (offset - base) % sizeof(FAUSTFLOAT) == 0) ? table[z] : 0;" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "const entry_t *p = std::lower_bound(sorted, sorted + widgets, offset, [](const entry_t &e, std::size_t k) -> bool { return e.offset < k; });" "\n";
+    o << "\t\t\t" "return (p != sorted + widgets && p->offset == offset) ? p->widget : 0;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    o << "\t" "FMINLINE const zone_index_t &zone_index() { static const zone_index_t index; return index; }" "\n";
+    o << "\t" "FMINLINE int index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) {"
+      << " return zone_index().find((std::size_t)((const char *)zone - (const char *)&x)); "
+      << "}" "\n";
+    o << "\t" "FMINLINE int active_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) {"
+      << " int i = index_of_zone(x, zone); return (i > 0) ? i - 1 : -1; "
+      << "}" "\n";
+    o << "\t" "FMINLINE int passive_index_of_zone(const FAUSTCLASS &x, const FAUSTFLOAT *zone) {"
+      << " int i = index_of_zone(x, zone); return (i < 0) ? -i - 1 : -1; "
+      << "}" "\n";
+}
+
+static void dump_groups(std::ostream &o, const Metadata &md, const String_Pool *pool, Blob_Writer *blob)
+{
+    const char *separator;
+
+    o << "\t" "FMSTATIC constexpr group_type_t group_type[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << "group_type_t::" << g.type; separator = ", "; }
+    o << "};" "\n";
+
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Group &g : md.groups)
+            texts.push_back(g.label);
+        dump_pooled_strings(o, *pool, blob, "group_label", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const group_label[groups ? groups : 1] = {";
+        separator = "";
+        for (const Metadata::Group &g : md.groups)
+            { o << separator << cstrlit(g.label); separator = ", "; }
+        o << "};" "\n";
+    }
+
+    if (pool) {
+        std::vector<std::string> texts;
+        for (const Metadata::Group &g : md.groups)
+            texts.push_back(g.address);
+        dump_pooled_strings(o, *pool, blob, "group_address", texts);
+    }
+    else {
+        o << "\t" "FMSTATIC const char *const group_address[groups ? groups : 1] = {";
+        separator = "";
+        for (const Metadata::Group &g : md.groups)
+            { o << separator << cstrlit(g.address); separator = ", "; }
+        o << "};" "\n";
+    }
+
+    o << "\t" "FMSTATIC constexpr int group_parent[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.parent; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned group_depth[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.depth; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned group_active_begin[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.active_begin; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned group_active_end[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.active_end; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned group_passive_begin[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.passive_begin; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned group_passive_end[groups ? groups : 1] = {";
+    separator = "";
+    for (const Metadata::Group &g : md.groups)
+        { o << separator << g.passive_end; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\n";
+
+    // the values of a subtree are indexed from the beginning of its range
+    o << "\t" "FMINLINE void group_reset(FAUSTCLASS &x, unsigned g) {"
+      << " for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, active_init[i]); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void group_store(const FAUSTCLASS &x, unsigned g, FAUSTFLOAT *v) {"
+      << " for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) *v++ = active_get(x, i); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void group_load(FAUSTCLASS &x, unsigned g, const FAUSTFLOAT *v) {"
+      << " for (unsigned i = group_active_begin[g]; i < group_active_end[g]; ++i) active_set(x, i, *v++); "
+      << "}" "\n";
+}
+
+static int find_active_by_name(const Metadata &md, gsl::cstring_span name)
+{
+    for (size_t i = 0, n = md.active.size(); i < n; ++i) {
+        const Metadata::Widget &w = md.active[i];
+        if (w.label == name || w.symbol == name)
+            return (int)i;
+    }
+    return -1;
+}
+
+static Voice_Widgets find_voice_widgets(const Metadata &md)
+{
+    // the control names which faust polyphonic hosts recognize
+    Voice_Widgets voice;
+    voice.freq = find_active_by_name(md, "freq");
+    voice.gain = find_active_by_name(md, "gain");
+    voice.gate = find_active_by_name(md, "gate");
+    voice.key = find_active_by_name(md, "key");
+    voice.note = find_active_by_name(md, "note");
+    voice.vel = find_active_by_name(md, "vel");
+    if (voice.vel == -1)
+        voice.vel = find_active_by_name(md, "velocity");
+    return voice;
+}
+
+static void dump_voice_conventions(std::ostream &o, const Metadata &md, const Voice_Widgets &voice, bool large_ui)
+{
+    int freq = voice.freq, gain = voice.gain, gate = voice.gate;
+    int key = voice.key, note = voice.note, vel = voice.vel;
+
+    o << "\t" "FMSTATIC constexpr int voice_freq = " << freq << ";" "\n";
+    o << "\t" "FMSTATIC constexpr int voice_gain = " << gain << ";" "\n";
+    o << "\t" "FMSTATIC constexpr int voice_gate = " << gate << ";" "\n";
+    o << "\t" "FMSTATIC constexpr int voice_key = " << key << ";" "\n";
+    o << "\t" "FMSTATIC constexpr int voice_note = " << note << ";" "\n";
+    o << "\t" "FMSTATIC constexpr int voice_vel = " << vel << ";" "\n";
+
+    o << "\n";
+
+    std::streamsize precision = o.precision(9);
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT midi_key_freq[128] = {";
+    for (int k = 0; k < 128; ++k)
+        o << (k ? ", " : "") << 440.0 * std::pow(2.0, (k - 69) / 12.0);
+    o << "};" "\n";
+    o.precision(precision);
+
+    o << "\n";
+
+    // the large UIs have no per-widget code, so they go through the tables
+    auto assign = [&md, large_ui](int idx, const char *constant, const std::string &value) -> std::string {
+        if (large_ui)
+            return std::string(" active_set(x, ") + constant + ", " + value + ");";
+        return " x." + md.active[idx].var + " = " + value + ";";
+    };
+
+    o << "\t" "FMINLINE void note_on(FAUSTCLASS &x, int key, int vel) {";
+    if (freq != -1)
+        o << assign(freq, "voice_freq", "midi_key_freq[key & 127]");
+    if (gain != -1)
+        o << assign(gain, "voice_gain", "vel * (FAUSTFLOAT)(1.0 / 127)");
+    if (key != -1)
+        o << assign(key, "voice_key", "(FAUSTFLOAT)key");
+    if (note != -1)
+        o << assign(note, "voice_note", "(FAUSTFLOAT)key");
+    if (vel != -1)
+        o << assign(vel, "voice_vel", "(FAUSTFLOAT)vel");
+    if (gate != -1)
+        o << assign(gate, "voice_gate", "1");
+    if (freq == -1 && key == -1 && note == -1)
+        o << " (void)key;";
+    if (gain == -1 && vel == -1)
+        o << " (void)vel;";
+    o << " }" "\n";
+
+    // without a gate, a voice is released by its gain
+    o << "\t" "FMINLINE void note_off(FAUSTCLASS &x) {";
+    if (gate != -1)
+        o << assign(gate, "voice_gate", "0");
+    else if (gain != -1)
+        o << assign(gain, "voice_gain", "0");
+    else
+        o << " (void)x;";
+    o << " }" "\n";
+}
+
+static void dump_passive_snapshot(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool large_ui)
+{
+    if (large_ui) {
+        o << "\t" "FMINLINE void passive_snapshot(const FAUSTCLASS &x, FAUSTFLOAT *out) {"
+          << " for (unsigned i = 0; i < passives; ++i) out[i] = passive_get(x, i); (void)x; (void)out; "
+          << "}" "\n";
+        return;
+    }
+
+    // read the zones directly, rather than through the offset table
+    o << "\t" "FMINLINE void passive_snapshot(const FAUSTCLASS &x, FAUSTFLOAT *out) {";
+    for (size_t i = 0, n = widgets.size(); i < n; ++i)
+        o << " out[" << i << "] = x." << widgets[i].var << ";";
+    if (widgets.empty())
+        o << " (void)x; (void)out;";
+    o << " }" "\n";
+}
+
+static void dump_snapshot_publisher(std::ostream &o, const Metadata &md)
+{
+    o << "\t" "FMSTATIC constexpr bool passive_is_db[] = {";
+    const char *separator = "";
+    for (const Metadata::Widget &w : md.passive) {
+        o << separator << (w.unit == "dB" ? "true" : "false");
+        separator = ", ";
+    }
+    o << "};" "\n";
+
+    o << "\n";
+
+    // seqlock: the audio thread never waits, a reader retries on a torn frame
+    o << "\t" "class passive_publisher_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "void publish(const FAUSTCLASS &x) noexcept {" "\n";
+    o << "\t\t\t" "unsigned s = seq_.load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "seq_.store(s + 1, std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "std::atomic_thread_fence(std::memory_order_release);" "\n";
+    // from the zones into the frame, without a copy on the stack
+    o << "\t\t\t" "for (unsigned i = 0; i < passives; ++i) data_[i].store(passive_get(x, i), std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "(void)x;" "\n";
+    o << "\t\t\t" "seq_.store(s + 2, std::memory_order_release);" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "bool try_read(FAUSTFLOAT *out) const noexcept {" "\n";
+    o << "\t\t\t" "unsigned s = seq_.load(std::memory_order_acquire);" "\n";
+    o << "\t\t\t" "if (s & 1) return false;" "\n";
+    o << "\t\t\t" "for (unsigned i = 0; i < passives; ++i) out[i] = data_[i].load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "std::atomic_thread_fence(std::memory_order_acquire);" "\n";
+    o << "\t\t\t" "return seq_.load(std::memory_order_relaxed) == s;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void read(FAUSTFLOAT *out) const noexcept { while (!try_read(out)); }" "\n";
+    o << "\t\t" "unsigned frames() const noexcept { return seq_.load(std::memory_order_acquire) >> 1; }" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "std::atomic<unsigned> seq_{0};" "\n";
+    o << "\t\t" "std::atomic<FAUSTFLOAT> data_[passives ? passives : 1] {};" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    // the fall is a fraction of the range of each bargraph, per call
+    o << "\t" "FMINLINE void passive_peak_hold(FAUSTFLOAT *hold, const FAUSTFLOAT *in, FAUSTFLOAT fall) {"
+      << " for (unsigned i = 0; i < passives; ++i) {"
+      << " FAUSTFLOAT h = hold[i] - fall * (passive_max[i] - passive_min[i]);"
+      << " hold[i] = (in[i] > h) ? in[i] : h; "
+      << "} }" "\n";
+    o << "\t" "FMINLINE void passive_normalize(FAUSTFLOAT *out, const FAUSTFLOAT *in) {"
+      << " for (unsigned i = 0; i < passives; ++i) {"
+      << " FAUSTFLOAT r = (in[i] - passive_min[i]) / (passive_max[i] - passive_min[i]);"
+      << " r = (r > 0) ? r : 0; out[i] = (r < 1) ? r : 1; "
+      << "} }" "\n";
+    // values in dB already are passed through
+    o << "\t" "FMINLINE void passive_to_db(FAUSTFLOAT *out, const FAUSTFLOAT *in, FAUSTFLOAT floor_db) {"
+      << " FAUSTFLOAT floor_lin = std::pow((FAUSTFLOAT)10, floor_db * (FAUSTFLOAT)0.05);"
+      << " for (unsigned i = 0; i < passives; ++i) {"
+      << " FAUSTFLOAT a = std::fabs(in[i]); a = (a > floor_lin) ? a : floor_lin;"
+      << " out[i] = passive_is_db[i] ? in[i] : 20 * std::log10(a); "
+      << "} }" "\n";
+}
+
+static void dump_smoothing(std::ostream &o, const Metadata &md)
+{
+    const char *separator;
+
+    std::vector<unsigned> slots;
+    std::vector<int> slot_of(md.active.size(), -1);
+    for (size_t i = 0, n = md.active.size(); i < n; ++i) {
+        if (md.active[i].smooth > 0) {
+            slot_of[i] = (int)slots.size();
+            slots.push_back(i);
+        }
+    }
+
+    o << "\t" "FMSTATIC constexpr unsigned smooths = " << slots.size() << ";" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned smooth_index[smooths ? smooths : 1] = {";
+    separator = "";
+    for (unsigned i : slots)
+        { o << separator << i; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr double smooth_time[smooths ? smooths : 1] = {";
+    separator = "";
+    for (unsigned i : slots)
+        { o << separator << md.active[i].smooth; separator = ", "; }
+    o << "};" "\n";
+
+    // below this distance to the target, jump to it rather than produce denormals
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT smooth_epsilon[smooths ? smooths : 1] = {";
+    separator = "";
+    for (unsigned i : slots)
+        { o << separator << 1e-6 * (md.active[i].max - md.active[i].min); separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr int active_smooth_slot[] = {";
+    separator = "";
+    for (int slot : slot_of)
+        { o << separator << slot; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\n";
+
+    // one-pole ramps of all smoothed parameters at once, once per sub-block
+    o << "\t" "class smoother_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "void prepare(double sample_rate, unsigned subblock) noexcept {" "\n";
+    o << "\t\t\t" "for (unsigned k = 0; k < smooths; ++k) coef_[k] = (FAUSTFLOAT)(1 - std::exp(-(double)subblock / (smooth_time[k] * sample_rate)));" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void reset(const FAUSTCLASS &x) noexcept {" "\n";
+    o << "\t\t\t" "for (unsigned k = 0; k < smooths; ++k) current_[k] = target_[k] = active_get(x, smooth_index[k]);" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void set(FAUSTCLASS &x, unsigned idx, FAUSTFLOAT v) noexcept {" "\n";
+    o << "\t\t\t" "int k = active_smooth_slot[idx];" "\n";
+    o << "\t\t\t" "if (k < 0) active_set(x, idx, v); else target_[k] = v;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void tick(FAUSTCLASS &x) noexcept {" "\n";
+    o << "\t\t\t" "for (unsigned k = 0; k < smooths; ++k) {" "\n";
+    o << "\t\t\t\t" "FAUSTFLOAT d = target_[k] - current_[k];" "\n";
+    o << "\t\t\t\t" "current_[k] = (std::fabs(d) > smooth_epsilon[k]) ? (current_[k] + d * coef_[k]) : target_[k];" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "for (unsigned k = 0; k < smooths; ++k) active_set(x, smooth_index[k], current_[k]);" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "FAUSTFLOAT target_[smooths ? smooths : 1] {};" "\n";
+    o << "\t\t" "FAUSTFLOAT current_[smooths ? smooths : 1] {};" "\n";
+    o << "\t\t" "FAUSTFLOAT coef_[smooths ? smooths : 1] {};" "\n";
+    o << "\t" "};" "\n";
+}
+
+static void dump_dirty_tracking(std::ostream &o, const Metadata &md, const Dump_Args &args)
+{
+    unsigned words = std::max(1u, ((unsigned)md.active.size() + 63) / 64);
+
+    o << "\t" "FMINLINE unsigned dirty_ctz(std::uint64_t b) {" "\n";
+    o << "\t" "#if defined(__GNUC__)" "\n";
+    o << "\t\t" "return (unsigned)__builtin_ctzll(b);" "\n";
+    o << "\t" "#elif defined(_MSC_VER) && defined(_WIN64)" "\n";
+    o << "\t\t" "unsigned long i; _BitScanForward64(&i, b); return (unsigned)i;" "\n";
+    o << "\t" "#else" "\n";
+    o << "\t\t" "unsigned i = 0; while (!(b & 1)) { b >>= 1; ++i; } return i;" "\n";
+    o << "\t" "#endif" "\n";
+    o << "\t" "}" "\n";
+
+    o << "\n";
+
+    // the set of active parameters changed since the last clear
+    o << "\t" "class dirty_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "static constexpr unsigned words = " << words << ";" "\n";
+    o << "\t\t" "void mark(unsigned idx) noexcept { bits_[idx >> 6] |= (std::uint64_t)1 << (idx & 63); }" "\n";
+    o << "\t\t" "bool test(unsigned idx) const noexcept { return (bits_[idx >> 6] >> (idx & 63)) & 1; }" "\n";
+    o << "\t\t" "bool any() const noexcept { std::uint64_t b = 0; for (unsigned w = 0; w < words; ++w) b |= bits_[w]; return b != 0; }" "\n";
+    o << "\t\t" "void clear() noexcept { for (unsigned w = 0; w < words; ++w) bits_[w] = 0; }" "\n";
+    o << "\t\t" "template <class F> void for_each(F f) const {" "\n";
+    o << "\t\t\t" "for (unsigned w = 0; w < words; ++w)" "\n";
+    o << "\t\t\t\t" "for (std::uint64_t b = bits_[w]; b; b &= b - 1) f(w * 64 + dirty_ctz(b));" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "template <class F> void consume(F f) {" "\n";
+    o << "\t\t\t" "for (unsigned w = 0; w < words; ++w) {" "\n";
+    o << "\t\t\t\t" "std::uint64_t b = bits_[w]; bits_[w] = 0;" "\n";
+    o << "\t\t\t\t" "for (; b; b &= b - 1) f(w * 64 + dirty_ctz(b));" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "std::uint64_t bits_[words] = {};" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    o << "\t" "FMINLINE void active_set(FAUSTCLASS &x, dirty_t &d, unsigned idx, FAUSTFLOAT v) {"
+      << " active_set(x, idx, v); d.mark(idx); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void active_set_clamped(FAUSTCLASS &x, dirty_t &d, unsigned idx, FAUSTFLOAT v) {"
+      << " active_set(x, idx, active_clamp(idx, v)); d.mark(idx); "
+      << "}" "\n";
+
+    if (args.large_ui)
+        return;
+
+    o << "\n";
+
+    std::vector<std::string> names = widget_names(md.active);
+    for (size_t i = 0, n = md.active.size(); i < n; ++i) {
+        o << "\t" << "FMINLINE void set_" << names[i] << "(FAUSTCLASS &x, dirty_t &d, FAUSTFLOAT v) {"
+          << " x." << md.active[i].var << " = v; d.mark(" << i << "); "
+          << "}" "\n";
+    }
+}
+
+static void dump_event_queues(std::ostream &o, const Metadata &md, const Dump_Args &args)
+{
+    // enough room for a few updates of every parameter between two blocks
+    unsigned capacity = next_power_of_two(std::max(64u, 4 * (unsigned)md.active.size()));
+
+    o << "\t" "struct param_event_t { unsigned index; FAUSTFLOAT value; };" "\n";
+
+    o << "\n";
+
+    // the scratch of the consumer, kept in the queue rather than on the
+    // stack; the slots are reset after use, so a drain costs its events only
+    o << "\t" "struct drain_state_t {" "\n";
+    o << "\t\t" "unsigned slot[actives ? actives : 1] = {};" "\n";
+    o << "\t\t" "unsigned order[actives ? actives : 1];" "\n";
+    o << "\t\t" "FAUSTFLOAT latest[actives ? actives : 1];" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    // pop at most one ring of events, and write each parameter only once
+    o << "\t" "template <class Queue, class Mark> FMINLINE void drain_queue(Queue &q, drain_state_t &s, FAUSTCLASS &x, Mark mark) {" "\n";
+    o << "\t\t" "unsigned count = 0;" "\n";
+    o << "\t\t" "param_event_t ev;" "\n";
+    o << "\t\t" "for (unsigned n = 0; n < Queue::capacity && q.pop(ev); ++n) {" "\n";
+    o << "\t\t\t" "if (ev.index >= actives) continue;" "\n";
+    o << "\t\t\t" "unsigned &slot = s.slot[ev.index];" "\n";
+    o << "\t\t\t" "if (!slot) { s.order[count] = ev.index; slot = ++count; }" "\n";
+    o << "\t\t\t" "s.latest[slot - 1] = ev.value;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "for (unsigned i = 0; i < count; ++i) { unsigned idx = s.order[i]; s.slot[idx] = 0; active_set(x, idx, s.latest[i]); mark(idx); }" "\n";
+    o << "\t" "}" "\n";
+
+    o << "\n";
+
+    // wait-free ring for one producer thread and one consumer thread
+    o << "\t" "class spsc_queue_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "static constexpr unsigned capacity = " << capacity << ";" "\n";
+    o << "\t\t" "bool push(unsigned idx, FAUSTFLOAT v) noexcept {" "\n";
+    o << "\t\t\t" "unsigned t = tail_.load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "if (t - head_cache_ == capacity) {" "\n";
+    o << "\t\t\t\t" "head_cache_ = head_.load(std::memory_order_acquire);" "\n";
+    o << "\t\t\t\t" "if (t - head_cache_ == capacity) return false;" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "ring_[t & (capacity - 1)] = param_event_t{idx, v};" "\n";
+    o << "\t\t\t" "tail_.store(t + 1, std::memory_order_release);" "\n";
+    o << "\t\t\t" "return true;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "bool pop(param_event_t &ev) noexcept {" "\n";
+    o << "\t\t\t" "unsigned h = head_.load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "if (h == tail_cache_) {" "\n";
+    o << "\t\t\t\t" "tail_cache_ = tail_.load(std::memory_order_acquire);" "\n";
+    o << "\t\t\t\t" "if (h == tail_cache_) return false;" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "ev = ring_[h & (capacity - 1)];" "\n";
+    o << "\t\t\t" "head_.store(h + 1, std::memory_order_release);" "\n";
+    o << "\t\t\t" "return true;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void drain_into(FAUSTCLASS &x) noexcept { drain_queue(*this, drain_, x, [](unsigned) {}); }" "\n";
+    if (args.dirty)
+        o << "\t\t" "void drain_into(FAUSTCLASS &x, dirty_t &d) noexcept { drain_queue(*this, drain_, x, [&d](unsigned i) { d.mark(i); }); }" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "alignas(64) std::atomic<unsigned> tail_{0};" "\n";
+    o << "\t\t" "unsigned head_cache_ = 0;" "\n";
+    o << "\t\t" "alignas(64) std::atomic<unsigned> head_{0};" "\n";
+    o << "\t\t" "unsigned tail_cache_ = 0;" "\n";
+    o << "\t\t" "param_event_t ring_[capacity];" "\n";
+    o << "\t\t" "drain_state_t drain_;" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    // lock-free bounded ring for many producers and one consumer (Vyukov)
+    o << "\t" "class mpsc_queue_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "static constexpr unsigned capacity = " << capacity << ";" "\n";
+    o << "\t\t" "mpsc_queue_t() noexcept {" "\n";
+    o << "\t\t\t" "for (unsigned i = 0; i < capacity; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "bool push(unsigned idx, FAUSTFLOAT v) noexcept {" "\n";
+    o << "\t\t\t" "unsigned pos = tail_.load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t" "for (;;) {" "\n";
+    o << "\t\t\t\t" "slot_t &s = slots_[pos & (capacity - 1)];" "\n";
+    o << "\t\t\t\t" "int dif = (int)(s.seq.load(std::memory_order_acquire) - pos);" "\n";
+    o << "\t\t\t\t" "if (dif < 0) return false;" "\n";
+    o << "\t\t\t\t" "if (dif > 0) pos = tail_.load(std::memory_order_relaxed);" "\n";
+    o << "\t\t\t\t" "else if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {" "\n";
+    o << "\t\t\t\t\t" "s.ev = param_event_t{idx, v};" "\n";
+    o << "\t\t\t\t\t" "s.seq.store(pos + 1, std::memory_order_release);" "\n";
+    o << "\t\t\t\t\t" "return true;" "\n";
+    o << "\t\t\t\t" "}" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "bool pop(param_event_t &ev) noexcept {" "\n";
+    o << "\t\t\t" "slot_t &s = slots_[head_ & (capacity - 1)];" "\n";
+    o << "\t\t\t" "if (s.seq.load(std::memory_order_acquire) != head_ + 1) return false;" "\n";
+    o << "\t\t\t" "ev = s.ev;" "\n";
+    o << "\t\t\t" "s.seq.store(head_ + capacity, std::memory_order_release);" "\n";
+    o << "\t\t\t" "++head_;" "\n";
+    o << "\t\t\t" "return true;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void drain_into(FAUSTCLASS &x) noexcept { drain_queue(*this, drain_, x, [](unsigned) {}); }" "\n";
+    if (args.dirty)
+        o << "\t\t" "void drain_into(FAUSTCLASS &x, dirty_t &d) noexcept { drain_queue(*this, drain_, x, [&d](unsigned i) { d.mark(i); }); }" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "struct slot_t { std::atomic<unsigned> seq; param_event_t ev; };" "\n";
+    o << "\t\t" "alignas(64) std::atomic<unsigned> tail_{0};" "\n";
+    o << "\t\t" "alignas(64) unsigned head_ = 0;" "\n";
+    o << "\t\t" "slot_t slots_[capacity];" "\n";
+    o << "\t\t" "drain_state_t drain_;" "\n";
+    o << "\t" "};" "\n";
+}
+
+static void dump_event_processing(std::ostream &o)
+{
+    o << "\t" "struct event_t { unsigned frame; unsigned index; FAUSTFLOAT value; };" "\n";
+
+    o << "\n";
+
+    // the events are sorted by frame; an event falling inside the minimum
+    // sub-block takes effect at the start of the following sub-block
+    o << "\t" "FMINLINE void process_events(FAUSTCLASS &x, int count, FAUSTFLOAT **in, FAUSTFLOAT **out, const event_t *events, unsigned n, int min_block = 16) {" "\n";
+    o << "\t\t" "FAUSTFLOAT *sub_in[inputs ? inputs : 1];" "\n";
+    o << "\t\t" "FAUSTFLOAT *sub_out[outputs ? outputs : 1];" "\n";
+    o << "\t\t" "unsigned e = 0;" "\n";
+    o << "\t\t" "for (int pos = 0; pos < count;) {" "\n";
+    o << "\t\t\t" "for (; e < n && (int)events[e].frame <= pos; ++e)" "\n";
+    o << "\t\t\t\t" "if (events[e].index < actives) active_set(x, events[e].index, events[e].value);" "\n";
+    o << "\t\t\t" "int end = (e < n && (int)events[e].frame < count) ? (int)events[e].frame : count;" "\n";
+    o << "\t\t\t" "if (end - pos < min_block) end = (pos + min_block < count) ? (pos + min_block) : count;" "\n";
+    o << "\t\t\t" "for (unsigned c = 0; c < inputs; ++c) sub_in[c] = in[c] + pos;" "\n";
+    o << "\t\t\t" "for (unsigned c = 0; c < outputs; ++c) sub_out[c] = out[c] + pos;" "\n";
+    o << "\t\t\t" "x.compute(end - pos, sub_in, sub_out);" "\n";
+    o << "\t\t\t" "pos = end;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "for (; e < n; ++e)" "\n";
+    o << "\t\t\t" "if (events[e].index < actives) active_set(x, events[e].index, events[e].value);" "\n";
+    o << "\t" "}" "\n";
+}
+
+struct Midi_Mapping {
+    enum Kind { Ctrl, KeyOn, KeyOff, Key, KeyPress, PitchWheel, ChanPress, Pgm, Kinds };
+    Kind kind = Kinds;
+    unsigned number = 0;
+    unsigned channel = 0; // 0 for any, otherwise 1-16
+};
+
+static bool parse_midi_mapping(const std::string &text, Midi_Mapping &mm)
+{
+    struct Kind_Name { const char *name; Midi_Mapping::Kind kind; bool has_number; };
+    static const Kind_Name kind_names[] = {
+        {"ctrl", Midi_Mapping::Ctrl, true},
+        {"keyon", Midi_Mapping::KeyOn, true},
+        {"keyoff", Midi_Mapping::KeyOff, true},
+        {"key", Midi_Mapping::Key, true},
+        {"keypress", Midi_Mapping::KeyPress, true},
+        {"pitchwheel", Midi_Mapping::PitchWheel, false},
+        {"chanpress", Midi_Mapping::ChanPress, false},
+        {"pgm", Midi_Mapping::Pgm, false},
+    };
+
+    std::istringstream in(text);
+    std::string name;
+    if (!(in >> name))
+        return false;
+
+    const Kind_Name *kn = nullptr;
+    for (const Kind_Name &k : kind_names) {
+        if (name == k.name)
+            kn = &k;
+    }
+    if (!kn)
+        return false;
+
+    mm.kind = kn->kind;
+    if (kn->has_number && (!(in >> mm.number) || mm.number > 127))
+        return false;
+
+    unsigned channel;
+    if (in >> channel) {
+        if (channel > 16)
+            return false;
+        mm.channel = channel;
+    }
+
+    return in.eof();
+}
+
+static void dump_midi_dispatch(std::ostream &o, const Metadata &md)
+{
+    const char *separator;
+
+    struct Entry { unsigned index; unsigned channel; float scale; float bias; };
+    std::vector<Entry> numbered[Midi_Mapping::Kinds][128];
+    std::vector<Entry> unnumbered[Midi_Mapping::Kinds];
+
+    for (size_t i = 0, n = md.active.size(); i < n; ++i) {
+        const Metadata::Widget &w = md.active[i];
+        for (const std::pair<std::string, std::string> &meta : w.metadata) {
+            if (meta.first != "midi")
+                continue;
+            Midi_Mapping mm;
+            if (!parse_midi_mapping(meta.second, mm)) {
+                warns() << "Unrecognized MIDI mapping `" << meta.second << "`\n";
+                continue;
+            }
+            Entry ent;
+            ent.index = i;
+            ent.channel = mm.channel;
+            ent.bias = w.min;
+            switch (mm.kind) {
+            case Midi_Mapping::PitchWheel:
+                ent.scale = (w.max - w.min) / 16383; break;
+            case Midi_Mapping::Pgm:
+                ent.scale = 1; ent.bias = 0; break;
+            default:
+                ent.scale = (w.max - w.min) / 127; break;
+            }
+            switch (mm.kind) {
+            case Midi_Mapping::PitchWheel:
+            case Midi_Mapping::ChanPress:
+            case Midi_Mapping::Pgm:
+                unnumbered[mm.kind].push_back(ent); break;
+            default:
+                numbered[mm.kind][mm.number].push_back(ent); break;
+            }
+        }
+    }
+
+    static const char *const kind_names[Midi_Mapping::Kinds] = {
+        "ctrl", "keyon", "keyoff", "key", "keypress", "pitchwheel", "chanpress", "pgm",
+    };
+
+    // 32-bit indices, which a large UI can exceed in 16 bits
+    o << "\t" "struct midi_map_t { unsigned index; unsigned char channel; FAUSTFLOAT scale; FAUSTFLOAT bias; };" "\n";
+
+    o << "\n";
+
+    // per message type, a direct-indexed table of 128 ranges into a map
+    std::streamsize precision = o.precision(9);
+    for (unsigned kind = 0; kind < Midi_Mapping::Kinds; ++kind) {
+        std::vector<Entry> all;
+        bool is_numbered = kind < Midi_Mapping::PitchWheel;
+
+        if (is_numbered) {
+            o << "\t" "FMSTATIC constexpr unsigned midi_" << kind_names[kind] << "_begin[129] = {";
+            separator = "";
+            for (unsigned number = 0; number < 128; ++number) {
+                o << separator << all.size();
+                all.insert(all.end(), numbered[kind][number].begin(), numbered[kind][number].end());
+                separator = ", ";
+            }
+            o << separator << all.size() << "};" "\n";
+        }
+        else {
+            all = unnumbered[kind];
+            o << "\t" "FMSTATIC constexpr unsigned midi_" << kind_names[kind] << "_count = " << all.size() << ";" "\n";
+        }
+
+        o << "\t" "FMSTATIC constexpr midi_map_t midi_" << kind_names[kind] << "_map[" << std::max<size_t>(1, all.size()) << "] = {";
+        separator = "";
+        for (const Entry &ent : all) {
+            o << separator << "{" << ent.index << ", " << ent.channel << ", " << ent.scale << ", " << ent.bias << "}";
+            separator = ", ";
+        }
+        o << "};" "\n";
+    }
+    o.precision(precision);
+
+    o << "\n";
+
+    o << "\t" "FMINLINE void midi_apply(FAUSTCLASS &x, const midi_map_t *m, const midi_map_t *end, unsigned ch, unsigned v) {"
+      << " for (; m != end; ++m) if (m->channel == 0 || m->channel == ch + 1) active_set(x, m->index, active_clamp(m->index, m->bias + (FAUSTFLOAT)v * m->scale)); "
+      << "}" "\n";
+
+    o << "\t" "FMINLINE void midi_dispatch(FAUSTCLASS &x, unsigned status, unsigned d1, unsigned d2) {" "\n";
+    o << "\t\t" "unsigned ch = status & 15;" "\n";
+    o << "\t\t" "d1 &= 127; d2 &= 127;" "\n";
+    o << "\t\t" "switch (status & 0xf0) {" "\n";
+    o << "\t\t" "case 0x80: case 0x90:" "\n";
+    o << "\t\t\t" "if ((status & 0xf0) == 0x90 && d2 != 0) {" "\n";
+    o << "\t\t\t\t" "midi_apply(x, midi_keyon_map + midi_keyon_begin[d1], midi_keyon_map + midi_keyon_begin[d1 + 1], ch, d2);" "\n";
+    o << "\t\t\t\t" "midi_apply(x, midi_key_map + midi_key_begin[d1], midi_key_map + midi_key_begin[d1 + 1], ch, d2);" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "else {" "\n";
+    o << "\t\t\t\t" "midi_apply(x, midi_keyoff_map + midi_keyoff_begin[d1], midi_keyoff_map + midi_keyoff_begin[d1 + 1], ch, d2);" "\n";
+    o << "\t\t\t\t" "midi_apply(x, midi_key_map + midi_key_begin[d1], midi_key_map + midi_key_begin[d1 + 1], ch, 0);" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "case 0xa0:" "\n";
+    o << "\t\t\t" "midi_apply(x, midi_keypress_map + midi_keypress_begin[d1], midi_keypress_map + midi_keypress_begin[d1 + 1], ch, d2);" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "case 0xb0:" "\n";
+    o << "\t\t\t" "midi_apply(x, midi_ctrl_map + midi_ctrl_begin[d1], midi_ctrl_map + midi_ctrl_begin[d1 + 1], ch, d2);" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "case 0xc0:" "\n";
+    o << "\t\t\t" "midi_apply(x, midi_pgm_map, midi_pgm_map + midi_pgm_count, ch, d1);" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "case 0xd0:" "\n";
+    o << "\t\t\t" "midi_apply(x, midi_chanpress_map, midi_chanpress_map + midi_chanpress_count, ch, d1);" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "case 0xe0:" "\n";
+    o << "\t\t\t" "midi_apply(x, midi_pitchwheel_map, midi_pitchwheel_map + midi_pitchwheel_count, ch, d1 | (d2 << 7));" "\n";
+    o << "\t\t\t" "break;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t" "}" "\n";
+}
+
+static void dump_address_dispatch(std::ostream &o, const std::vector<Metadata::Widget> &widgets, bool is_active, bool pooled, Blob_Writer *blob)
+{
+    const char *prefix = is_active ? "active" : "passive";
+
+    // on duplicate addresses, only the first widget can be found
+    std::vector<uint64_t> keys;
+    std::vector<unsigned> key_widget;
+    std::unordered_set<uint64_t> seen;
+    for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+        uint64_t key = hash_string(widgets[i].address);
+        if (!seen.insert(key).second) {
+            warns() << "Duplicate address `" << widgets[i].address << "`\n";
+            continue;
+        }
+        keys.push_back(key);
+        key_widget.push_back(i);
+    }
+
+    Perfect_Hash ph;
+    if (!build_perfect_hash(keys, ph)) {
+        errs() << "Could not build the perfect hash of addresses\n";
+        ph.buckets = ph.slots = 1;
+        ph.seeds.assign(1, 0);
+        ph.slot_key.assign(1, -1);
+    }
+    for (int &key : ph.slot_key) {
+        if (key != -1)
+            key = key_widget[key];
+    }
+
+    dump_perfect_hash(o, ph, std::string(prefix) + "_address", blob);
+
+    o << "\n";
+
+    o << "\t" "FMINLINE int " << prefix << "_index_of_address(const char *addr, std::size_t len) {"
+      << " std::uint64_t k = hash_string(addr, len);"
+      << " int i = " << prefix << "_address_slot[hash_mix(k, " << prefix << "_address_seed[hash_mix(k, 0) & (" << prefix << "_address_buckets - 1)]) & (" << prefix << "_address_slots - 1)];";
+    if (pooled)
+        o << " return (i >= 0 && " << prefix << "_address_size[i] == len && !std::memcmp(string_pool + " << prefix << "_address_offset[i], addr, len)) ? i : -1; ";
+    else
+        o << " return (i >= 0 && !std::strncmp(" << prefix << "_address[i], addr, len) && " << prefix << "_address[i][len] == '\\0') ? i : -1; ";
+    o << "}" "\n";
+
+    if (is_active) {
+        o << "\t" "FMINLINE bool osc_set(FAUSTCLASS &x, const char *addr, std::size_t len, FAUSTFLOAT v) {"
+          << " int i = active_index_of_address(addr, len);"
+          << " if (i < 0) return false;"
+          << " active_set(x, (unsigned)i, active_clamp((unsigned)i, v)); return true; "
+          << "}" "\n";
+    }
+    else {
+        o << "\t" "FMINLINE bool osc_get(const FAUSTCLASS &x, const char *addr, std::size_t len, FAUSTFLOAT &v) {"
+          << " int i = active_index_of_address(addr, len);"
+          << " if (i >= 0) { v = active_get(x, (unsigned)i); return true; }"
+          << " i = passive_index_of_address(addr, len);"
+          << " if (i >= 0) { v = passive_get(x, (unsigned)i); return true; }"
+          << " return false; "
+          << "}" "\n";
+    }
+}
+
+static void dump_morphing(std::ostream &o, const Metadata &md)
+{
+    const char *separator;
+
+    // The normalized domain of a scale is an affine map of a warped value,
+    // so interpolating there is interpolating the warped values. Each scale
+    // is processed in its own loop, over a generated list of indices.
+    std::vector<unsigned> indices[3];
+    for (size_t i = 0, n = md.active.size(); i < n; ++i)
+        indices[(int)md.active[i].scale].push_back(i);
+
+    static const char *const scale_names[3] = {"linear", "log", "exp"};
+
+    for (unsigned scale = 0; scale < 3; ++scale) {
+        o << "\t" "FMSTATIC constexpr unsigned morph_" << scale_names[scale] << "_count = " << indices[scale].size() << ";" "\n";
+        o << "\t" "FMSTATIC constexpr unsigned morph_" << scale_names[scale] << "_index[" << std::max<size_t>(1, indices[scale].size()) << "] = {";
+        separator = "";
+        for (unsigned i : indices[scale])
+            { o << separator << i; separator = ", "; }
+        o << "};" "\n";
+    }
+
+    o << "\n";
+
+    // the exponential is taken relative to the maximum, to not overflow
+    o << "\t" "FMINLINE FAUSTFLOAT morph_warp(scale_t s, unsigned i, FAUSTFLOAT v) {"
+      << " return (s == scale_t::log) ? std::log((v > (FAUSTFLOAT)1e-30) ? v : (FAUSTFLOAT)1e-30) : (s == scale_t::exp) ? std::exp(v - active_max[i]) : v; "
+      << "}" "\n";
+    o << "\t" "FMINLINE FAUSTFLOAT morph_unwarp(scale_t s, unsigned i, FAUSTFLOAT v) {"
+      << " return (s == scale_t::log) ? std::exp(v) : (s == scale_t::exp) ? (std::log((v > (FAUSTFLOAT)1e-30) ? v : (FAUSTFLOAT)1e-30) + active_max[i]) : v; "
+      << "}" "\n";
+
+    o << "\n";
+
+    // interpolate between two value arrays, and pass each value, with the
+    // discrete widgets snapped, to the output as it is computed
+    o << "\t" "template <class Out> FMINLINE void morph_each(Out out, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) {" "\n";
+    for (unsigned scale = 0; scale < 3; ++scale) {
+        if (indices[scale].empty())
+            continue;
+        const char *s = scale_names[scale];
+        o << "\t\t" "for (unsigned k = 0; k < morph_" << s << "_count; ++k) {"
+          << " unsigned i = morph_" << s << "_index[k];"
+          << " FAUSTFLOAT wa = morph_warp(scale_t::" << s << ", i, a[i]), wb = morph_warp(scale_t::" << s << ", i, b[i]);"
+          << " out(i, active_clamp(i, morph_unwarp(scale_t::" << s << ", i, wa + t * (wb - wa)))); "
+          << "}" "\n";
+    }
+    if (md.active.empty())
+        o << "\t\t" "(void)out; (void)a; (void)b; (void)t;" "\n";
+    o << "\t" "}" "\n";
+
+    // weighted mean of n value arrays, the weights need not be normalized
+    o << "\t" "template <class Out> FMINLINE void morph_each_n(Out out, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) {" "\n";
+    o << "\t\t" "FAUSTFLOAT wsum = 0;" "\n";
+    o << "\t\t" "for (unsigned j = 0; j < n; ++j) wsum += w[j];" "\n";
+    o << "\t\t" "FAUSTFLOAT winv = (wsum != 0) ? (1 / wsum) : 0;" "\n";
+    for (unsigned scale = 0; scale < 3; ++scale) {
+        if (indices[scale].empty())
+            continue;
+        const char *s = scale_names[scale];
+        o << "\t\t" "for (unsigned k = 0; k < morph_" << s << "_count; ++k) {"
+          << " unsigned i = morph_" << s << "_index[k];"
+          << " FAUSTFLOAT acc = 0;"
+          << " for (unsigned j = 0; j < n; ++j) acc += w[j] * morph_warp(scale_t::" << s << ", i, v[j][i]);"
+          << " out(i, active_clamp(i, morph_unwarp(scale_t::" << s << ", i, acc * winv))); "
+          << "}" "\n";
+    }
+    if (md.active.empty())
+        o << "\t\t" "(void)out; (void)v; (void)winv;" "\n";
+    o << "\t" "}" "\n";
+
+    o << "\n";
+
+    o << "\t" "FMINLINE void morph_values(FAUSTFLOAT *out, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) {"
+      << " morph_each([out](unsigned i, FAUSTFLOAT v) { out[i] = v; }, a, b, t); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void morph_values_n(FAUSTFLOAT *out, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) {"
+      << " morph_each_n([out](unsigned i, FAUSTFLOAT r) { out[i] = r; }, v, w, n); "
+      << "}" "\n";
+
+    o << "\n";
+
+    // straight into the instance, without a scratch array on the stack
+    o << "\t" "FMINLINE void morph(FAUSTCLASS &x, const FAUSTFLOAT *a, const FAUSTFLOAT *b, FAUSTFLOAT t) {"
+      << " morph_each([&x](unsigned i, FAUSTFLOAT v) { active_set(x, i, v); }, a, b, t); "
+      << "}" "\n";
+    o << "\t" "FMINLINE void morph_n(FAUSTCLASS &x, const FAUSTFLOAT *const *v, const FAUSTFLOAT *w, unsigned n) {"
+      << " morph_each_n([&x](unsigned i, FAUSTFLOAT r) { active_set(x, i, r); }, v, w, n); "
+      << "}" "\n";
+}
+
+static void dump_migration(std::ostream &o, const Metadata &md, const Metadata &oldmd)
+{
+    const char *separator;
+
+    struct Entry { unsigned from; unsigned to; float scale; float bias; };
+    std::vector<Entry> entries;
+    std::vector<int> map(oldmd.active.size(), -1);
+    std::vector<bool> used(md.active.size(), false);
+
+    // match by address, then by symbol, then by label
+    for (unsigned pass = 0; pass < 3; ++pass) {
+        auto key = [pass](const Metadata::Widget &w) -> const std::string & {
+            return (pass == 0) ? w.address : (pass == 1) ? w.symbol : w.label; };
+
+        // the unmatched new widgets by key, the first in the layout last
+        std::unordered_map<std::string, std::vector<unsigned>> candidates;
+        for (size_t j = md.active.size(); j-- > 0;) {
+            if (!used[j])
+                candidates[key(md.active[j])].push_back(j);
+        }
+
+        for (size_t i = 0, n = oldmd.active.size(); i < n; ++i) {
+            if (map[i] != -1)
+                continue;
+            auto it = candidates.find(key(oldmd.active[i]));
+            if (it == candidates.end() || it->second.empty())
+                continue;
+            unsigned j = it->second.back();
+            it->second.pop_back();
+            map[i] = j;
+            used[j] = true;
+        }
+    }
+
+    for (size_t i = 0, n = oldmd.active.size(); i < n; ++i) {
+        if (map[i] == -1) {
+            warns() << "The control `" << oldmd.active[i].address << "` was removed\n";
+            continue;
+        }
+
+        const Metadata::Widget &ow = oldmd.active[i];
+        const Metadata::Widget &nw = md.active[map[i]];
+
+        // keep the value when it still means the same, then clamp it;
+        // otherwise rescale it from the old range into the new one
+        Entry ent{(unsigned)i, (unsigned)map[i], 1, 0};
+        bool same_meaning = ow.unit == nw.unit && is_discrete_widget(ow) == is_discrete_widget(nw);
+        if (!same_meaning && ow.max != ow.min) {
+            ent.scale = (nw.max - nw.min) / (ow.max - ow.min);
+            ent.bias = nw.min - ow.min * ent.scale;
+        }
+        entries.push_back(ent);
+    }
+
+    o << "\t" "FMSTATIC constexpr std::uint64_t migrate_fingerprint = " << hexlit(layout_fingerprint(oldmd)) << ";" "\n";
+    o << "\t" "FMSTATIC constexpr unsigned migrate_actives = " << oldmd.active.size() << ";" "\n";
+    o << "\t" "FMSTATIC constexpr unsigned migrate_count = " << entries.size() << ";" "\n";
+
+    o << "\t" "FMSTATIC constexpr int migrate_map[migrate_actives ? migrate_actives : 1] = {";
+    separator = "";
+    for (int j : map)
+        { o << separator << j; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned migrate_from[migrate_count ? migrate_count : 1] = {";
+    separator = "";
+    for (const Entry &ent : entries)
+        { o << separator << ent.from; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr unsigned migrate_to[migrate_count ? migrate_count : 1] = {";
+    separator = "";
+    for (const Entry &ent : entries)
+        { o << separator << ent.to; separator = ", "; }
+    o << "};" "\n";
+
+    std::streamsize precision = o.precision(9);
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT migrate_scale[migrate_count ? migrate_count : 1] = {";
+    separator = "";
+    for (const Entry &ent : entries)
+        { o << separator << ent.scale; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr FAUSTFLOAT migrate_bias[migrate_count ? migrate_count : 1] = {";
+    separator = "";
+    for (const Entry &ent : entries)
+        { o << separator << ent.bias; separator = ", "; }
+    o << "};" "\n";
+    o.precision(precision);
+
+    o << "\n";
+
+    // the new controls which did not exist keep their current values
+    o << "\t" "FMINLINE void migrate(const FAUSTFLOAT *old_values, FAUSTCLASS &x) {"
+      << " for (unsigned k = 0; k < migrate_count; ++k) {"
+      << " unsigned i = migrate_to[k];"
+      << " active_set(x, i, active_clamp(i, old_values[migrate_from[k]] * migrate_scale[k] + migrate_bias[k])); "
+      << "} }" "\n";
+}
+
+void dump_capi(std::ostream &o, const Metadata &md, unsigned float_size)
+{
+    std::string p = md.classname + "_meta_";
+    std::string guard = md.classname + "_meta_capi";
+    std::string impl;
+    for (char c : md.classname + "_meta_capi_implementation")
+        impl.push_back((c >= 'a' && c <= 'z') ? (c - 'a' + 'A') : c);
+
+    // C99 has no prefix of UTF-8 literals
+    auto clit = [](gsl::cstring_span text) -> std::string { return cstrlit(text).substr(2); };
+
+    o << "/* plain C interface to the metadata of `" << md.classname << "`, for FFI hosts */" "\n";
+    o << "/* define " << impl << " in one C++ translation unit which knows FAUSTCLASS */" "\n";
+    o << "\n";
+
+    o << "#ifndef __" << guard << "_H__" "\n";
+    o << "#define __" << guard << "_H__" "\n";
+    o << "\n";
+    o << "#include <stddef.h>" "\n";
+    o << "#include <stdint.h>" "\n";
+    o << "\n";
+    o << "#ifdef __cplusplus" "\n";
+    o << "extern \"C\" {" "\n";
+    o << "#endif" "\n";
+    o << "\n";
+
+    o << "typedef " << (float_size == sizeof(double) ? "double" : "float") << " " << p << "float_t;" "\n";
+    o << "\n";
+
+    o << "enum { ";
+    o << p << "button = 0, " << p << "checkbox = 1, " << p << "vslider = 2, " << p << "hslider = 3, " << p << "nentry = 4, ";
+    o << p << "vbargraph = 0, " << p << "hbargraph = 1 };" "\n";
+    o << "enum { " << p << "linear = 0, " << p << "log = 1, " << p << "exp = 2 };" "\n";
+    o << "enum { " << p << "vgroup = 0, " << p << "hgroup = 1, " << p << "tgroup = 2 };" "\n";
+    o << "enum { " << p << "hidden = 1, " << p << "knob = 2, " << p << "menu = 4, " << p << "radio = 8, "
+      << p << "led = 16, " << p << "numerical = 32, " << p << "smooth = 64, " << p << "midi = 128 };" "\n";
+    o << "\n";
+
+    // fixed-size fields, in an order without padding
+    o << "typedef struct { const char *key; const char *value; } " << p << "pair_t;" "\n";
+    o << "typedef struct {" "\n";
+    o << "\t" "const char *label, *symbol, *address, *unit, *tooltip;" "\n";
+    o << "\t" "uint32_t offset; /* of the zone, in bytes from the instance */" "\n";
+    o << "\t" "int32_t type, scale;" "\n";
+    o << "\t" "uint32_t flags, uid;" "\n";
+    o << "\t" "uint32_t meta_begin, meta_count; /* in the pairs of widgets */" "\n";
+    o << "\t" "uint32_t reserved;" "\n";
+    o << "\t" << p << "float_t init, min, max, step;" "\n";
+    o << "} " << p << "widget_t;" "\n";
+    o << "typedef struct {" "\n";
+    o << "\t" "const char *label, *address;" "\n";
+    o << "\t" "int32_t type, parent;" "\n";
+    o << "\t" "uint32_t depth;" "\n";
+    o << "\t" "uint32_t active_begin, active_end, passive_begin, passive_end;" "\n";
+    o << "\t" "uint32_t reserved;" "\n";
+    o << "} " << p << "group_t;" "\n";
+    o << "typedef struct {" "\n";
+    o << "\t" "const char *name, *author, *copyright, *license, *version, *classname;" "\n";
+    o << "\t" "uint32_t inputs, outputs, actives, passives, groups, metadata_count;" "\n";
+    o << "\t" "uint32_t float_size, widget_size;" "\n";
+    o << "\t" "uint64_t layout_fingerprint;" "\n";
+    o << "\t" "const " << p << "pair_t *metadata;" "\n";
+    o << "\t" "const " << p << "widget_t *active, *passive;" "\n";
+    o << "\t" "const " << p << "group_t *group;" "\n";
+    o << "\t" "const " << p << "pair_t *widget_metadata;" "\n";
+    o << "} " << p << "info_t;" "\n";
+    o << "\n";
+
+    o << "extern const " << p << "info_t " << p << "info;" "\n";
+    o << "extern const " << p << "widget_t " << p << "active[];" "\n";
+    o << "extern const " << p << "widget_t " << p << "passive[];" "\n";
+    o << "extern const " << p << "group_t " << p << "group[];" "\n";
+    o << "\n";
+    o << p << "float_t " << p << "active_get(const void *dsp, uint32_t idx);" "\n";
+    o << "void " << p << "active_set(void *dsp, uint32_t idx, " << p << "float_t v);" "\n";
+    o << p << "float_t " << p << "passive_get(const void *dsp, uint32_t idx);" "\n";
+    o << "\n";
+
+    o << "static inline " << p << "float_t *" << p << "active_zone(void *dsp, uint32_t idx) {"
+      << " return (" << p << "float_t *)((char *)dsp + " << p << "active[idx].offset); }" "\n";
+    o << "static inline const " << p << "float_t *" << p << "passive_zone(const void *dsp, uint32_t idx) {"
+      << " return (const " << p << "float_t *)((const char *)dsp + " << p << "passive[idx].offset); }" "\n";
+    o << "\n";
+
+    o << "#ifdef " << impl << "\n";
+    o << "#ifdef __GNUC__" "\n";
+    o << "#pragma GCC diagnostic push" "\n";
+    o << "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"" "\n";
+    o << "#endif" "\n";
+
+    o << "static const " << p << "pair_t " << p << "metadata[" << std::max<size_t>(1, md.metadata.size()) << "] = {";
+    const char *separator = "";
+    for (const std::pair<std::string, std::string> &meta : md.metadata) {
+        o << separator << "{" << clit(meta.first) << ", " << clit(meta.second) << "}";
+        separator = ", ";
+    }
+    if (md.metadata.empty())
+        o << "{0, 0}";
+    o << "};" "\n";
+
+    size_t pairs = 0;
+    for (const std::vector<Metadata::Widget> *widgets : {&md.active, &md.passive}) {
+        for (const Metadata::Widget &w : *widgets)
+            pairs += w.metadata.size();
+    }
+    o << "static const " << p << "pair_t " << p << "widget_metadata[" << std::max<size_t>(1, pairs) << "] = {";
+    separator = "";
+    for (const std::vector<Metadata::Widget> *widgets : {&md.active, &md.passive}) {
+        for (const Metadata::Widget &w : *widgets) {
+            for (const std::pair<std::string, std::string> &meta : w.metadata) {
+                o << "\n" "\t" << "{" << clit(meta.first) << ", " << clit(meta.second) << "},";
+                separator = "\n";
+            }
+        }
+    }
+    if (pairs == 0)
+        o << "{0, 0}";
+    o << separator << "};" "\n";
+
+    size_t meta_begin = 0;
+    for (int kind = 0; kind < 2; ++kind) {
+        bool is_active = kind == 0;
+        const std::vector<Metadata::Widget> &widgets = is_active ? md.active : md.passive;
+        std::vector<uint32_t> uids = widget_uids(widgets, false);
+        o << "const " << p << "widget_t " << p << (is_active ? "active" : "passive") << "[" << std::max<size_t>(1, widgets.size()) << "] = {";
+        for (size_t i = 0, n = widgets.size(); i < n; ++i) {
+            const Metadata::Widget &w = widgets[i];
+            unsigned type = (unsigned)w.type - (is_active ? 0 : (unsigned)Metadata::Widget::Type::VBarGraph);
+            o << "\n" "\t" "{" << clit(w.label) << ", " << clit(w.symbol) << ", " << clit(w.address) << ", "
+              << clit(w.unit) << ", " << clit(w.tooltip) << ", "
+              << "(uint32_t)offsetof(FAUSTCLASS, " << w.var << "), "
+              << type << ", " << (unsigned)w.scale << ", " << widget_meta_flags(w) << ", " << uids[i] << "u, "
+              << meta_begin << ", " << w.metadata.size() << ", 0, "
+              << w.init << ", " << w.min << ", " << w.max << ", " << w.step << "},";
+            meta_begin += w.metadata.size();
+        }
+        if (widgets.empty())
+            o << "{0}";
+        else
+            o << "\n";
+        o << "};" "\n";
+    }
+
+    o << "const " << p << "group_t " << p << "group[" << std::max<size_t>(1, md.groups.size()) << "] = {";
+    for (const Metadata::Group &g : md.groups) {
+        o << "\n" "\t" "{" << clit(g.label) << ", " << clit(g.address) << ", "
+          << (unsigned)g.type << ", " << g.parent << ", " << g.depth << ", "
+          << g.active_begin << ", " << g.active_end << ", " << g.passive_begin << ", " << g.passive_end << ", 0},";
+    }
+    if (md.groups.empty())
+        o << "{0}";
+    else
+        o << "\n";
+    o << "};" "\n";
+
+    o << "const " << p << "info_t " << p << "info = {" "\n";
+    o << "\t" << clit(md.name) << ", " << clit(md.author) << ", " << clit(md.copyright) << ", "
+      << clit(md.license) << ", " << clit(md.version) << ", " << clit(md.classname) << "," "\n";
+    o << "\t" << md.inputs << ", " << md.outputs << ", " << md.active.size() << ", " << md.passive.size() << ", "
+      << md.groups.size() << ", " << md.metadata.size() << "," "\n";
+    o << "\t" "sizeof(" << p << "float_t), sizeof(" << p << "widget_t)," "\n";
+    o << "\t" << hexlit(layout_fingerprint(md)) << "," "\n";
+    o << "\t" << p << "metadata, " << p << "active, " << p << "passive, " << p << "group, " << p << "widget_metadata" "\n";
+    o << "};" "\n";
+
+    o << p << "float_t " << p << "active_get(const void *dsp, uint32_t idx) { return *" << p << "active_zone((void *)dsp, idx); }" "\n";
+    o << "void " << p << "active_set(void *dsp, uint32_t idx, " << p << "float_t v) { *" << p << "active_zone(dsp, idx) = v; }" "\n";
+    o << p << "float_t " << p << "passive_get(const void *dsp, uint32_t idx) { return *" << p << "passive_zone(dsp, idx); }" "\n";
+
+    o << "#ifdef __GNUC__" "\n";
+    o << "#pragma GCC diagnostic pop" "\n";
+    o << "#endif" "\n";
+    o << "#endif" "\n";
+    o << "\n";
+
+    o << "#ifdef __cplusplus" "\n";
+    o << "} // extern \"C\"" "\n";
+    o << "#endif" "\n";
+    o << "\n";
+    o << "#endif /* __" << guard << "_H__ */" "\n";
+}
+
+static const std::string jsonlit(gsl::cstring_span text)
+{
+    std::string lit;
+    lit.push_back('"');
+
+    for (char c : text) {
+        switch (c) {
+        case '\b': lit.append("\\b"); break;
+        case '\t': lit.append("\\t"); break;
+        case '\n': lit.append("\\n"); break;
+        case '\f': lit.append("\\f"); break;
+        case '\r': lit.append("\\r"); break;
+        case '"': case '\\': lit.push_back('\\'); lit.push_back(c); break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char hex[8];
+                std::snprintf(hex, sizeof(hex), "\\u%04x", (unsigned char)c);
+                lit.append(hex);
+            }
+            else
+                lit.push_back(c);
+            break;
+        }
+    }
+
+    lit.push_back('"');
+    return lit;
+}
+
+static void json_meta(std::ostream &j, const std::vector<std::pair<std::string, std::string>> &metadata)
+{
+    j << "\"meta\":[";
+    const char *separator = "";
+    for (const std::pair<std::string, std::string> &meta : metadata) {
+        j << separator << "{" << jsonlit(meta.first) << ":" << jsonlit(meta.second) << "}";
+        separator = ",";
+    }
+    j << "]";
+}
+
+static void json_widget(std::ostream &j, const Metadata::Widget &w)
+{
+    std::ostringstream type;
+    type << w.type;
+
+    j << "{\"type\":" << jsonlit(type.str())
+      << ",\"label\":" << jsonlit(w.label)
+      << ",\"address\":" << jsonlit(w.address);
+    if (!w.metadata.empty()) {
+        j << ",";
+        json_meta(j, w.metadata);
+    }
+
+    switch (w.type) {
+    case Metadata::Widget::Type::Button:
+    case Metadata::Widget::Type::CheckBox:
+        break;
+    case Metadata::Widget::Type::VBarGraph:
+    case Metadata::Widget::Type::HBarGraph:
+        j << ",\"min\":" << w.min << ",\"max\":" << w.max;
+        break;
+    default:
+        j << ",\"init\":" << w.init << ",\"min\":" << w.min << ",\"max\":" << w.max << ",\"step\":" << w.step;
+        break;
+    }
+
+    j << "}";
+}
+
+static void json_group(std::ostream &j, const Metadata &md, unsigned index)
+{
+    const Metadata::Group &g = md.groups[index];
+
+    std::ostringstream type;
+    type << g.type;
+
+    j << "{\"type\":" << jsonlit(type.str()) << ",\"label\":" << jsonlit(g.label) << ",\"items\":[";
+    const char *separator = "";
+    for (const Metadata::Group::Item &item : g.items) {
+        j << separator;
+        switch (item.kind) {
+        case Metadata::Group::Item::Kind::Active:
+            json_widget(j, md.active[item.index]);
+            break;
+        case Metadata::Group::Item::Kind::Passive:
+            json_widget(j, md.passive[item.index]);
+            break;
+        case Metadata::Group::Item::Kind::Group:
+            json_group(j, md, item.index);
+            break;
+        }
+        separator = ",";
+    }
+    j << "]}";
+}
+
+static const std::string json_descriptor(const Metadata &md)
+{
+    // like the JSONUI of faust, without the fields unknown before compilation
+    std::ostringstream j;
+    j << "{\"name\":" << jsonlit(md.name)
+      << ",\"inputs\":" << md.inputs
+      << ",\"outputs\":" << md.outputs
+      << ",";
+    json_meta(j, md.metadata);
+
+    // the top-level groups, then the widgets out of the layout
+    j << ",\"ui\":[";
+    const char *separator = "";
+    std::vector<bool> active_seen(md.active.size());
+    std::vector<bool> passive_seen(md.passive.size());
+    for (size_t i = 0, n = md.groups.size(); i < n; ++i) {
+        const Metadata::Group &g = md.groups[i];
+        if (g.parent != -1)
+            continue;
+        j << separator;
+        json_group(j, md, i);
+        separator = ",";
+        std::fill(active_seen.begin() + g.active_begin, active_seen.begin() + g.active_end, true);
+        std::fill(passive_seen.begin() + g.passive_begin, passive_seen.begin() + g.passive_end, true);
+    }
+    for (size_t i = 0, n = md.active.size(); i < n; ++i) {
+        if (!active_seen[i])
+            { j << separator; json_widget(j, md.active[i]); separator = ","; }
+    }
+    for (size_t i = 0, n = md.passive.size(); i < n; ++i) {
+        if (!passive_seen[i])
+            { j << separator; json_widget(j, md.passive[i]); separator = ","; }
+    }
+    j << "]}";
+
+    return j.str();
+}
+
+static void dump_json(std::ostream &o, const Metadata &md, bool compress)
+{
+    std::string json = json_descriptor(md);
+
+    o << "\t" "FMSTATIC constexpr std::size_t json_size = " << json.size() << ";" "\n";
+
+    if (!compress) {
+        // in pieces, under the limits of string literals of some compilers
+        const size_t piece = 2048;
+        o << "\t" "FMSTATIC constexpr char json[] =";
+        for (size_t i = 0, n = json.size(); i < n || i == 0; i += piece)
+            o << "\n" "\t\t" << cstrlit(gsl::cstring_span(json).subspan(i, std::min(piece, n - i)));
+        o << ";" "\n";
+        return;
+    }
+
+    // a zlib stream, to decompress with `uncompress` into `json_size` bytes
+    std::string z = zlib_compress(json);
+    o << "\t" "FMSTATIC constexpr std::size_t json_zlib_size = " << z.size() << ";" "\n";
+    o << "\t" "FMSTATIC constexpr unsigned char json_zlib[] = {";
+    for (size_t i = 0, n = z.size(); i < n; ++i) {
+        if (i % 32 == 0)
+            o << "\n" "\t\t";
+        o << (unsigned)(unsigned char)z[i] << ",";
+    }
+    o << "\n" "\t" "};" "\n";
+}
+
+static const std::string cstrlit(gsl::cstring_span text)
+{
+    std::string lit;
+    lit.push_back('u');
+    lit.push_back('8');
+    lit.push_back('"');
+
+    for (char c : text) {
+        switch (c) {
+        case '\a': lit.push_back('\\'); lit.push_back('a'); break;
+        case '\b': lit.push_back('\\'); lit.push_back('b'); break;
+        case '\t': lit.push_back('\\'); lit.push_back('t'); break;
+        case '\n': lit.push_back('\\'); lit.push_back('n'); break;
+        case '\v': lit.push_back('\\'); lit.push_back('v'); break;
+        case '\f': lit.push_back('\\'); lit.push_back('f'); break;
+        case '\r': lit.push_back('\\'); lit.push_back('r'); break;
+        case '"': case '\\': lit.push_back('\\'); lit.push_back(c); break;
+        case '\0': lit.append("\\000"); break;
+        default: lit.push_back(c); break;
+        }
+    }
+
+    lit.push_back('"');
+    return lit;
+}
+
+static const std::string mangle(gsl::cstring_span name)
+{
+    std::string id;
+    size_t n = name.size();
+    id.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        char c = name[i];
+        bool al = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        bool num = c >= '0' && c <= '9';
+        c = (!al && (!num || i == 0)) ? '_' : c;
         id.push_back(c);
     }
 
@@ -425,6 +2692,20 @@ Metadata::Widget::Scale Metadata::Widget::scale_from_name(gsl::cstring_span name
     return s;
 }
 
+Metadata::Group::Type Metadata::Group::type_from_name(gsl::cstring_span name)
+{
+    Metadata::Group::Type t = (Metadata::Group::Type)-1;
+
+    if (name == "vgroup")
+        t = Type::VGroup;
+    else if (name == "hgroup")
+        t = Type::HGroup;
+    else if (name == "tgroup")
+        t = Type::TGroup;
+
+    return t;
+}
+
 std::ostream &operator<<(std::ostream &o, Metadata::Widget::Type t)
 {
     switch (t) {
@@ -452,3 +2733,15 @@ std::ostream &operator<<(std::ostream &o, Metadata::Widget::Scale s)
     assert(false);
     return o;
 }
+
+std::ostream &operator<<(std::ostream &o, Metadata::Group::Type t)
+{
+    switch (t) {
+    case Metadata::Group::Type::VGroup: return o << "vgroup";
+    case Metadata::Group::Type::HGroup: return o << "hgroup";
+    case Metadata::Group::Type::TGroup: return o << "tgroup";
+    }
+
+    assert(false);
+    return o;
+}
@@ -9,6 +9,9 @@
 #include <string>
 #include <vector>
 #include <iosfwd>
+#include <cstdint>
+
+class Blob_Writer;
 
 struct Metadata {
     std::string name;
@@ -30,6 +33,7 @@ struct Metadata {
         std::string label;
         std::string var;
         std::string symbol;
+        std::string address;
         float init = 0;
         float min = 0;
         float max = 0;
@@ -40,6 +44,8 @@ struct Metadata {
         std::string unit;
         Scale scale = Scale::Linear;
         std::string tooltip;
+        float smooth = 0; // seconds
+        bool symbol_given = false; // by md.symbol, rather than from the label
 
         static Type type_from_name(gsl::cstring_span name);
         static Scale scale_from_name(gsl::cstring_span name);
@@ -47,10 +53,65 @@ struct Metadata {
 
     std::vector<Widget> active;
     std::vector<Widget> passive;
+
+    struct Group {
+        enum class Type { VGroup, HGroup, TGroup };
+
+        Type type = (Type)-1;
+        std::string label;
+        std::string address;
+        int parent = -1;
+        unsigned depth = 0;
+        // the widgets of the subtree, contiguous in the order of the layout
+        unsigned active_begin = 0;
+        unsigned active_end = 0;
+        unsigned passive_begin = 0;
+        unsigned passive_end = 0;
+        // the direct children, in the order of the layout
+        struct Item {
+            enum class Kind { Active, Passive, Group };
+            Kind kind;
+            unsigned index;
+        };
+        std::vector<Item> items;
+
+        static Type type_from_name(gsl::cstring_span name);
+    };
+
+    std::vector<Group> groups;
+};
+
+struct Dump_Args {
+    bool queues = false;
+    bool dirty = false;
+    bool snapshots = false;
+    bool smoothing = false;
+    bool events = false;
+    bool midi = false;
+    bool osc = false;
+    bool presets = false;
+    bool morphing = false;
+    bool descriptors = false;
+    bool inline_definitions = false;
+    bool pooled_strings = false;
+    bool xmacros = false;
+    bool json = false;
+    bool json_zlib = false;
+    // table-driven output without per-widget functions, from this many widgets
+    bool large_ui = false;
+    size_t large_ui_threshold = 4096;
+    // the previous version of the DSP, to migrate its state from
+    const Metadata *migration = nullptr;
+    // the receiver of the bulk tables, instead of the header
+    Blob_Writer *blob = nullptr;
 };
 
 int extract_metadata(const pugi::xml_document &doc, Metadata &md);
-void dump_metadata(std::ostream &o, Metadata &md);
+uint64_t layout_fingerprint(const Metadata &md);
+void dump_metadata(std::ostream &o, Metadata &md, const Dump_Args &args);
+// emit a C header of the metadata, for FFI hosts
+void dump_capi(std::ostream &o, const Metadata &md, unsigned float_size);
 
 std::ostream &operator<<(std::ostream &o, Metadata::Widget::Type t);
 std::ostream &operator<<(std::ostream &o, Metadata::Widget::Scale s);
+std::ostream &operator<<(std::ostream &o, Metadata::Group::Type t);
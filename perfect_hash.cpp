@@ -0,0 +1,152 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "perfect_hash.h"
+#include "blob.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+uint64_t hash_string(gsl::cstring_span text)
+{
+    uint64_t h = 0xcbf29ce484222325u;
+    for (char c : text) {
+        h ^= (unsigned char)c;
+        h *= 0x100000001b3u;
+    }
+    return h;
+}
+
+uint32_t hash_mix(uint64_t key, uint32_t seed)
+{
+    uint64_t h = key ^ (seed * 0x9e3779b97f4a7c15u);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdu;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53u;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+static unsigned power_of_two_above(unsigned n)
+{
+    unsigned p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+static bool try_perfect_hash(const std::vector<uint64_t> &keys, Perfect_Hash &ph)
+{
+    const unsigned max_seed = 1u << 16;
+
+    std::vector<std::vector<unsigned>> bucket_keys(ph.buckets);
+    for (unsigned i = 0, n = keys.size(); i < n; ++i)
+        bucket_keys[hash_mix(keys[i], 0) & (ph.buckets - 1)].push_back(i);
+
+    // place the largest buckets first, while the table is emptiest
+    std::vector<unsigned> order(ph.buckets);
+    for (unsigned b = 0; b < ph.buckets; ++b)
+        order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) -> bool {
+        return bucket_keys[a].size() > bucket_keys[b].size(); });
+
+    ph.seeds.assign(ph.buckets, 0);
+    ph.slot_key.assign(ph.slots, -1);
+
+    std::vector<unsigned> taken;
+    for (unsigned b : order) {
+        const std::vector<unsigned> &bk = bucket_keys[b];
+        if (bk.empty())
+            break;
+
+        bool placed = false;
+        for (uint32_t seed = 1; !placed && seed < max_seed; ++seed) {
+            taken.clear();
+            placed = true;
+            for (unsigned i : bk) {
+                unsigned slot = hash_mix(keys[i], seed) & (ph.slots - 1);
+                if (ph.slot_key[slot] != -1 ||
+                    std::find(taken.begin(), taken.end(), slot) != taken.end())
+                    { placed = false; break; }
+                taken.push_back(slot);
+            }
+            if (placed) {
+                ph.seeds[b] = seed;
+                for (size_t j = 0; j < bk.size(); ++j)
+                    ph.slot_key[taken[j]] = bk[j];
+            }
+        }
+
+        if (!placed)
+            return false;
+    }
+
+    return true;
+}
+
+bool build_perfect_hash(const std::vector<uint64_t> &keys, Perfect_Hash &ph)
+{
+    unsigned n = keys.size();
+
+    std::vector<uint64_t> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+        return false;
+
+    ph.buckets = power_of_two_above(std::max(1u, n / 2));
+    ph.slots = power_of_two_above(std::max(1u, n + n / 4));
+
+    // on failure, retry with a sparser table
+    for (unsigned attempt = 0; attempt < 8; ++attempt) {
+        if (try_perfect_hash(keys, ph))
+            return true;
+        ph.slots *= 2;
+    }
+
+    return false;
+}
+
+void dump_hash_functions(std::ostream &o)
+{
+    o << "\t" "FMINLINE std::uint64_t hash_string(const char *s, std::size_t n) {"
+      << " std::uint64_t h = 0xcbf29ce484222325u;"
+      << " for (std::size_t i = 0; i < n; ++i) { h ^= (unsigned char)s[i]; h *= 0x100000001b3u; }"
+      << " return h; "
+      << "}" "\n";
+    o << "\t" "FMINLINE std::uint32_t hash_mix(std::uint64_t key, std::uint32_t seed) {"
+      << " std::uint64_t h = key ^ (seed * 0x9e3779b97f4a7c15u);"
+      << " h ^= h >> 33; h *= 0xff51afd7ed558ccdu; h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53u; h ^= h >> 33;"
+      << " return (std::uint32_t)h; "
+      << "}" "\n";
+}
+
+void dump_perfect_hash(std::ostream &o, const Perfect_Hash &ph, const std::string &prefix, Blob_Writer *blob)
+{
+    const char *separator;
+
+    o << "\t" "FMSTATIC constexpr unsigned " << prefix << "_buckets = " << ph.buckets << ";" "\n";
+    o << "\t" "FMSTATIC constexpr unsigned " << prefix << "_slots = " << ph.slots << ";" "\n";
+
+    if (blob) {
+        blob->add_integers(prefix + "_seed", std::vector<int64_t>(ph.seeds.begin(), ph.seeds.end()), 4);
+        dump_blob_table(o, *blob, "std::uint32_t", prefix + "_seed", ph.seeds.size());
+        blob->add_integers(prefix + "_slot", std::vector<int64_t>(ph.slot_key.begin(), ph.slot_key.end()), 4);
+        dump_blob_table(o, *blob, "int", prefix + "_slot", ph.slot_key.size());
+        return;
+    }
+
+    o << "\t" "FMSTATIC constexpr std::uint32_t " << prefix << "_seed[] = {";
+    separator = "";
+    for (uint32_t seed : ph.seeds)
+        { o << separator << seed; separator = ", "; }
+    o << "};" "\n";
+
+    o << "\t" "FMSTATIC constexpr int " << prefix << "_slot[] = {";
+    separator = "";
+    for (int key : ph.slot_key)
+        { o << separator << key; separator = ", "; }
+    o << "};" "\n";
+}
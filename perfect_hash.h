@@ -0,0 +1,34 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include "thirdparty/gsl-lite.hpp"
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+
+class Blob_Writer;
+
+// 64-bit FNV-1a, identical to the `hash_string` of the generated code
+uint64_t hash_string(gsl::cstring_span text);
+// mixer of the perfect hash, identical to the `hash_mix` of the generated code
+uint32_t hash_mix(uint64_t key, uint32_t seed);
+
+// minimal-ish perfect hash of distinct keys, by hash and displace
+struct Perfect_Hash {
+    unsigned buckets = 0; // power of two
+    unsigned slots = 0; // power of two
+    std::vector<uint32_t> seeds; // per bucket
+    std::vector<int> slot_key; // key index, or -1
+};
+
+bool build_perfect_hash(const std::vector<uint64_t> &keys, Perfect_Hash &ph);
+
+// emit the generated counterparts of `hash_string` and `hash_mix`
+void dump_hash_functions(std::ostream &o);
+// emit the tables of a perfect hash, named `<prefix>_seed` and `<prefix>_slot`,
+// into the blob if there is one
+void dump_perfect_hash(std::ostream &o, const Perfect_Hash &ph, const std::string &prefix, Blob_Writer *blob = nullptr);
@@ -0,0 +1,167 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "preset_bank.h"
+#include "perfect_hash.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+template <class T> static void write_raw(std::ostream &o, T x)
+{
+    o.write((const char *)&x, sizeof(T));
+}
+
+int write_preset_bank(std::ostream &o, const Metadata &md, const std::vector<Preset> &presets, unsigned value_size)
+{
+    if (value_size != sizeof(float) && value_size != sizeof(double))
+        return -1;
+
+    uint32_t actives = md.active.size();
+    uint32_t count = presets.size();
+
+    std::string pool;
+    std::vector<uint32_t> name_offsets;
+    for (const Preset &p : presets) {
+        if (p.values.size() != actives)
+            return -1;
+        name_offsets.push_back(pool.size());
+        pool.append(p.name);
+        pool.push_back('\0');
+    }
+
+    struct Index_Entry { uint64_t hash; uint32_t preset; };
+    std::vector<Index_Entry> index;
+    for (uint32_t i = 0; i < count; ++i)
+        index.push_back(Index_Entry{hash_string(presets[i].name), i});
+    std::stable_sort(index.begin(), index.end(), [](const Index_Entry &a, const Index_Entry &b) -> bool {
+        return a.hash < b.hash; });
+
+    o.write("FMPB", 4);
+    write_raw<uint32_t>(o, 1);
+    write_raw<uint64_t>(o, layout_fingerprint(md));
+    write_raw<uint32_t>(o, actives);
+    write_raw<uint32_t>(o, value_size);
+    write_raw<uint32_t>(o, count);
+    write_raw<uint32_t>(o, pool.size());
+
+    for (const Preset &p : presets) {
+        for (double value : p.values) {
+            if (value_size == sizeof(float))
+                write_raw<float>(o, value);
+            else
+                write_raw<double>(o, value);
+        }
+    }
+    if ((count * actives * value_size) & 7)
+        write_raw<uint32_t>(o, 0);
+
+    for (uint32_t offset : name_offsets)
+        write_raw<uint32_t>(o, offset);
+    if (count & 1)
+        write_raw<uint32_t>(o, 0);
+
+    for (const Index_Entry &ent : index) {
+        write_raw<uint64_t>(o, ent.hash);
+        write_raw<uint32_t>(o, ent.preset);
+        write_raw<uint32_t>(o, 0);
+    }
+
+    o.write(pool.data(), pool.size());
+
+    return o.good() ? 0 : -1;
+}
+
+void dump_preset_bank(std::ostream &o)
+{
+    o << "\t" "struct preset_bank_header_t { char magic[4]; std::uint32_t version; std::uint64_t fingerprint; std::uint32_t actives, value_size, presets, names_size; };" "\n";
+    o << "\t" "struct preset_bank_entry_t { std::uint64_t hash; std::uint32_t preset, unused; };" "\n";
+    o << "\t" "static_assert(sizeof(preset_bank_header_t) == 32 && sizeof(preset_bank_entry_t) == 16, \"the records have no padding\");" "\n";
+
+    o << "\n";
+
+    o << "\t" "FMINLINE void preset_store(const FAUSTCLASS &x, FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) v[i] = active_get(x, i); }" "\n";
+    o << "\t" "FMINLINE void preset_apply(FAUSTCLASS &x, const FAUSTFLOAT *v) { for (unsigned i = 0; i < actives; ++i) active_set(x, i, v[i]); }" "\n";
+
+    o << "\n";
+
+    // a read-only view of a bank in memory, for example a mapped file
+    o << "\t" "class preset_bank_t {" "\n";
+    o << "\t" "public:" "\n";
+    o << "\t\t" "bool open(const void *data, std::size_t size) noexcept {" "\n";
+    o << "\t\t\t" "const char *p = (const char *)data;" "\n";
+    o << "\t\t\t" "preset_bank_header_t h;" "\n";
+    o << "\t\t\t" "if (size < sizeof(h)) return false;" "\n";
+    o << "\t\t\t" "std::memcpy(&h, p, sizeof(h));" "\n";
+    o << "\t\t\t" "if (std::memcmp(h.magic, \"FMPB\", 4) || h.version != 1 || h.fingerprint != layout_fingerprint || h.actives != actives || h.value_size != sizeof(FAUSTFLOAT)) return false;" "\n";
+    o << "\t\t\t" "std::size_t values_size = ((std::size_t)h.presets * actives * sizeof(FAUSTFLOAT) + 7) & ~(std::size_t)7;" "\n";
+    o << "\t\t\t" "std::size_t names_size = ((std::size_t)h.presets + (h.presets & 1)) * 4;" "\n";
+    o << "\t\t\t" "std::size_t index_size = (std::size_t)h.presets * sizeof(preset_bank_entry_t);" "\n";
+    o << "\t\t\t" "if (size < sizeof(h) + values_size + names_size + index_size + h.names_size) return false;" "\n";
+    o << "\t\t\t" "presets_ = h.presets;" "\n";
+    o << "\t\t\t" "values_ = (const FAUSTFLOAT *)(p + sizeof(h));" "\n";
+    o << "\t\t\t" "names_ = (const std::uint32_t *)(p + sizeof(h) + values_size);" "\n";
+    o << "\t\t\t" "index_ = (const preset_bank_entry_t *)(p + sizeof(h) + values_size + names_size);" "\n";
+    o << "\t\t\t" "pool_ = p + sizeof(h) + values_size + names_size + index_size;" "\n";
+    o << "\t\t\t" "pool_size_ = h.names_size;" "\n";
+    o << "\t\t\t" "return pool_size_ == 0 || pool_[pool_size_ - 1] == '\\0';" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "unsigned size() const noexcept { return presets_; }" "\n";
+    o << "\t\t" "const FAUSTFLOAT *values(unsigned i) const noexcept { return values_ + (std::size_t)i * actives; }" "\n";
+    o << "\t\t" "const char *name(unsigned i) const noexcept { return (i < presets_ && names_[i] < pool_size_) ? (pool_ + names_[i]) : \"\"; }" "\n";
+    o << "\t\t" "int find(const char *name, std::size_t len) const noexcept {" "\n";
+    o << "\t\t\t" "std::uint64_t k = hash_string(name, len);" "\n";
+    o << "\t\t\t" "unsigned lo = 0, hi = presets_;" "\n";
+    o << "\t\t\t" "while (lo < hi) { unsigned mid = (lo + hi) / 2; if (index_[mid].hash < k) lo = mid + 1; else hi = mid; }" "\n";
+    o << "\t\t\t" "for (; lo < presets_ && index_[lo].hash == k; ++lo) {" "\n";
+    o << "\t\t\t\t" "const char *n = this->name(index_[lo].preset);" "\n";
+    o << "\t\t\t\t" "if (!std::strncmp(n, name, len) && n[len] == '\\0') return (int)index_[lo].preset;" "\n";
+    o << "\t\t\t" "}" "\n";
+    o << "\t\t\t" "return -1;" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "void apply(FAUSTCLASS &x, unsigned i) const noexcept { if (i < presets_) preset_apply(x, values(i)); }" "\n";
+    o << "\t" "private:" "\n";
+    o << "\t\t" "unsigned presets_ = 0;" "\n";
+    o << "\t\t" "const FAUSTFLOAT *values_ = nullptr;" "\n";
+    o << "\t\t" "const std::uint32_t *names_ = nullptr;" "\n";
+    o << "\t\t" "const preset_bank_entry_t *index_ = nullptr;" "\n";
+    o << "\t\t" "const char *pool_ = nullptr;" "\n";
+    o << "\t\t" "std::uint32_t pool_size_ = 0;" "\n";
+    o << "\t" "};" "\n";
+
+    o << "\n";
+
+    // with a null destination, only compute the size of the bank
+    o << "\t" "FMINLINE std::size_t preset_bank_write(void *dst, const FAUSTFLOAT *const *values, const char *const *names, unsigned presets) {" "\n";
+    o << "\t\t" "std::size_t values_size = ((std::size_t)presets * actives * sizeof(FAUSTFLOAT) + 7) & ~(std::size_t)7;" "\n";
+    o << "\t\t" "std::size_t names_size = ((std::size_t)presets + (presets & 1)) * 4;" "\n";
+    o << "\t\t" "std::size_t index_size = (std::size_t)presets * sizeof(preset_bank_entry_t);" "\n";
+    o << "\t\t" "std::size_t pool_size = 0;" "\n";
+    o << "\t\t" "for (unsigned i = 0; i < presets; ++i) pool_size += std::strlen(names[i]) + 1;" "\n";
+    o << "\t\t" "std::size_t size = sizeof(preset_bank_header_t) + values_size + names_size + index_size + pool_size;" "\n";
+    o << "\t\t" "if (!dst) return size;" "\n";
+    o << "\t\t" "char *p = (char *)dst;" "\n";
+    // the padding is zero, for reproducible files which leak no memory
+    o << "\t\t" "std::memset(p, 0, size);" "\n";
+    o << "\t\t" "preset_bank_header_t h = {{'F', 'M', 'P', 'B'}, 1, layout_fingerprint, actives, sizeof(FAUSTFLOAT), presets, (std::uint32_t)pool_size};" "\n";
+    o << "\t\t" "std::memcpy(p, &h, sizeof(h));" "\n";
+    o << "\t\t" "char *pv = p + sizeof(h);" "\n";
+    o << "\t\t" "std::uint32_t *pn = (std::uint32_t *)(pv + values_size);" "\n";
+    o << "\t\t" "preset_bank_entry_t *pi = (preset_bank_entry_t *)((char *)pn + names_size);" "\n";
+    o << "\t\t" "char *pp = (char *)pi + index_size;" "\n";
+    o << "\t\t" "std::uint32_t offset = 0;" "\n";
+    o << "\t\t" "for (unsigned i = 0; i < presets; ++i) {" "\n";
+    o << "\t\t\t" "std::memcpy(pv + (std::size_t)i * actives * sizeof(FAUSTFLOAT), values[i], actives * sizeof(FAUSTFLOAT));" "\n";
+    o << "\t\t\t" "std::size_t len = std::strlen(names[i]);" "\n";
+    o << "\t\t\t" "std::memcpy(pp + offset, names[i], len + 1);" "\n";
+    o << "\t\t\t" "pn[i] = offset;" "\n";
+    o << "\t\t\t" "pi[i] = preset_bank_entry_t{hash_string(names[i], len), i, 0};" "\n";
+    o << "\t\t\t" "offset += (std::uint32_t)(len + 1);" "\n";
+    o << "\t\t" "}" "\n";
+    o << "\t\t" "if (presets & 1) pn[presets] = 0;" "\n";
+    o << "\t\t" "std::stable_sort(pi, pi + presets, [](const preset_bank_entry_t &a, const preset_bank_entry_t &b) { return a.hash < b.hash; });" "\n";
+    o << "\t\t" "return size;" "\n";
+    o << "\t" "}" "\n";
+}
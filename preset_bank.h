@@ -0,0 +1,29 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include "metadata.h"
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+
+// Binary preset bank, in host byte order:
+//   header     magic "FMPB", version, fingerprint, actives, value size,
+//              preset count, size of the name pool (32 bytes)
+//   values     presets * actives values, in active index order, padded to 8 bytes
+//   names      presets * u32 offsets into the name pool, padded to 8 bytes
+//   index      presets * {u64 hash, u32 preset, u32 unused}, sorted by hash
+//   pool       the nul-terminated preset names
+
+struct Preset {
+    std::string name;
+    std::vector<double> values;
+};
+
+int write_preset_bank(std::ostream &o, const Metadata &md, const std::vector<Preset> &presets, unsigned value_size);
+
+// emit the generated reader and writer of preset banks
+void dump_preset_bank(std::ostream &o);
@@ -0,0 +1,53 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#include "string_pool.h"
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+void String_Pool::add(gsl::cstring_span text)
+{
+    offsets_.emplace(gsl::to_string(text), 0);
+}
+
+void String_Pool::build()
+{
+    std::vector<const std::string *> texts;
+    texts.reserve(offsets_.size());
+    for (const auto &ent : offsets_)
+        texts.push_back(&ent.first);
+
+    // in decreasing order of the reversed strings, a suffix comes after
+    // the strings which end with it
+    std::sort(texts.begin(), texts.end(),
+              [](const std::string *a, const std::string *b) -> bool {
+                  return std::lexicographical_compare(b->rbegin(), b->rend(), a->rbegin(), a->rend()); });
+
+    data_.clear();
+    const std::string *prev = nullptr;
+    uint32_t prev_offset = 0;
+    for (const std::string *text : texts) {
+        uint32_t offset;
+        if (prev && prev->size() >= text->size() &&
+            std::equal(text->rbegin(), text->rend(), prev->rbegin()))
+            offset = prev_offset + (prev->size() - text->size());
+        else {
+            offset = data_.size();
+            data_.append(*text);
+            data_.push_back('\0');
+        }
+        offsets_[*text] = offset;
+        prev = text;
+        prev_offset = offset;
+    }
+}
+
+uint32_t String_Pool::offset(gsl::cstring_span text) const
+{
+    auto it = offsets_.find(gsl::to_string(text));
+    assert(it != offsets_.end());
+    return it->second;
+}
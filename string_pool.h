@@ -0,0 +1,25 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#include "thirdparty/gsl-lite.hpp"
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// a pool of nul-terminated strings, referred to by offset
+//   the strings are all added before the pool is built, so that a string
+//   which ends another one is stored as the tail of the longer string
+class String_Pool {
+public:
+    void add(gsl::cstring_span text);
+    void build();
+    uint32_t offset(gsl::cstring_span text) const;
+    const std::string &data() const { return data_; }
+
+private:
+    std::string data_;
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
@@ -0,0 +1,13 @@
+#!/bin/sh
+# stands for faust in the tests: the "dsp" file is the XML to produce
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -O) dir="$2"; shift 2 ;;
+        -o) cpp="$2"; shift 2 ;;
+        -I|-cn|-pn) shift 2 ;;
+        -*) shift ;;
+        *) dsp="$1"; shift ;;
+    esac
+done
+base=$(basename "$dsp")
+cp "$dsp" "$dir/$base.xml" && : > "$dir/$cpp"
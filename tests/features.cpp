@@ -0,0 +1,137 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// the runtime of the optional features, the same in every storage mode
+
+#define FAUSTFLOAT float
+
+class mydsp {
+public:
+    virtual ~mydsp() {}
+    int fSampleRate = 44100;
+    FAUSTFLOAT fHslider0 = 440;
+    double fRec0[2] = {};
+    FAUSTFLOAT fHslider1 = 0.5, fButton0 = 0, fEntry0 = 1, fCheckbox0 = 0;
+    int iVec0[3] = {};
+    FAUSTFLOAT fVslider0 = 1000, fHslider2 = 0.7, fHslider3 = 60, fVbargraph0 = -60, fHbargraph0 = 0;
+    virtual void compute(int count, FAUSTFLOAT **inputs, FAUSTFLOAT **outputs)
+    {
+        for (int c = 0; c < 2; ++c)
+            for (int i = 0; i < count; ++i)
+                outputs[c][i] = inputs[c][i] * fHslider1;
+    }
+};
+
+#define FAUSTCLASS mydsp
+#include "synth.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace mydsp_meta;
+
+// the active widgets, in the order of the layout
+enum { FREQ, GAIN, GATE, KEY, MODE, CUTOFF, RESO, BYPASS };
+// the passive widgets
+enum { ENV, LEVEL };
+
+template <class Queue> static int check_queue()
+{
+    static Queue q;
+    mydsp x;
+    int failures = 0;
+
+    for (int round = 0; round < 3; ++round) {
+        q.push(GAIN, 0.1f);
+        q.push(FREQ, 100.0f + round);
+        q.push(GAIN, 0.2f);
+        q.push(actives, 1); // out of range, ignored
+        dirty_t d;
+        q.drain_into(x, d);
+        unsigned n = 0;
+        d.for_each([&n](unsigned) { ++n; });
+        failures += x.fHslider0 != 100.0f + round || x.fHslider1 != 0.2f || n != 2;
+    }
+
+    return failures;
+}
+
+int main()
+{
+    mydsp x;
+    int failures = 0;
+
+    static_assert(actives == 8 && passives == 2, "unexpected widgets");
+
+    // clamp and quantize
+    failures += active_clamp(MODE, 7) != 3;
+    failures += active_clamp(MODE, 1.4f) != 1;
+    failures += active_clamp(MODE, -1) != 0;
+    failures += active_clamp(FREQ, 1) != 20;
+    failures += active_clamp(BYPASS, 0.7f) != 1;
+    failures += active_clamp(CUTOFF, 123.25f) != 123.25f; // continuous
+
+    // uid
+    for (unsigned i = 0; i < actives; ++i)
+        failures += active_index_of_uid(active_uid[i]) != (int)i;
+    for (unsigned i = 0; i < passives; ++i)
+        failures += passive_index_of_uid(passive_uid[i]) != (int)i;
+    failures += active_index_of_uid(active_uid[0] + 1) != -1;
+
+    // OSC
+    const char gain[] = "/test_synth/voice/gain";
+    const char env[] = "/test_synth/voice/env";
+    failures += active_index_of_address(gain, std::strlen(gain)) != GAIN;
+    failures += passive_index_of_address(env, std::strlen(env)) != ENV;
+    failures += active_index_of_address(env, std::strlen(env)) != -1;
+    failures += !osc_set(x, gain, std::strlen(gain), 0.75f) || x.fHslider1 != 0.75f;
+    failures += osc_set(x, env, std::strlen(env), 1);
+    FAUSTFLOAT v = 0;
+    x.fHbargraph0 = 0.25f;
+    failures += !osc_get(x, env, std::strlen(env), v) || v != 0.25f;
+
+    // zone
+    failures += active_index_of_zone(x, &x.fHslider0) != FREQ;
+    failures += active_index_of_zone(x, &x.fCheckbox0) != BYPASS;
+    failures += active_index_of_zone(x, &x.fVbargraph0) != -1;
+    failures += passive_index_of_zone(x, &x.fVbargraph0) != LEVEL;
+    failures += index_of_zone(x, (const FAUSTFLOAT *)&x.fRec0[0]) != 0;
+
+    // queue coalescing
+    failures += check_queue<spsc_queue_t>();
+    failures += check_queue<mpsc_queue_t>();
+
+    // snapshot
+    passive_publisher_t publisher;
+    x.fHbargraph0 = 0.5f;
+    x.fVbargraph0 = -12;
+    publisher.publish(x);
+    FAUSTFLOAT snapshot[passives] = {};
+    failures += !publisher.try_read(snapshot) || publisher.frames() != 1;
+    failures += snapshot[ENV] != 0.5f || snapshot[LEVEL] != -12;
+
+    // preset bank
+    FAUSTFLOAT init[actives], high[actives];
+    preset_store(x, init);
+    x.fHslider0 = 880;
+    preset_store(x, high);
+    const FAUSTFLOAT *values[] = {init, high};
+    const char *names[] = {"init", "high"};
+    std::vector<char> bank_data(preset_bank_write(nullptr, values, names, 2));
+    preset_bank_write(bank_data.data(), values, names, 2);
+    preset_bank_t bank;
+    failures += !bank.open(bank_data.data(), bank_data.size()) || bank.size() != 2;
+    failures += bank.find("high", 4) < 0 || bank.find("none", 4) != -1;
+    bank.apply(x, bank.find("init", 4));
+    failures += x.fHslider0 != 440;
+    bank.apply(x, bank.find("high", 4));
+    failures += x.fHslider0 != 880;
+    failures += std::strcmp(bank.name(bank.find("init", 4)), "init") != 0;
+    failures += bank.open(bank_data.data(), bank_data.size() - 1);
+
+    if (failures)
+        std::fprintf(stderr, "%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+//          Copyright Jean Pierre Cimalando 2019.
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// the symbols which are keywords or which repeat give valid, distinct names
+
+#define FAUSTFLOAT float
+
+class mydsp {
+public:
+    FAUSTFLOAT fCheckbox0 = 0, fHslider0 = 1000, fHslider1 = 2000, fHslider2 = 3000, fVbargraph0 = 0;
+};
+
+#define FAUSTCLASS mydsp
+#include "keywords.h"
+#include <cstdio>
+
+int main()
+{
+    mydsp x;
+    int failures = 0;
+
+#if defined(KEYWORDS_LARGE)
+    using namespace mydsp_meta::active_index;
+    using namespace mydsp_meta::passive_index;
+    static_assert(i_switch == 0 && i_cutoff_1 == 1 && i_cutoff_2_ == 2 && i_cutoff_2 == 3, "unexpected index");
+    static_assert(i_int == 0, "unexpected index");
+    mydsp_meta::active_set(x, i_cutoff_1, 100);
+    mydsp_meta::active_set(x, i_cutoff_2_, 200);
+
+    #define CHECK_NAME(index, name, var) failures += ((index) != (name));
+    mydsp_meta_ACTIVE_WIDGETS(CHECK_NAME)
+    mydsp_meta_PASSIVE_WIDGETS(CHECK_NAME)
+    #undef CHECK_NAME
+#elif defined(KEYWORDS_DIRTY)
+    mydsp_meta::dirty_t d;
+    mydsp_meta::set_switch(x, d, 1);
+    mydsp_meta::set_cutoff_1(x, d, 100);
+    mydsp_meta::set_cutoff_2_(x, d, 200);
+    failures += !d.test(0) || !d.test(1) || !d.test(2) || d.test(3);
+#else
+    mydsp_meta::set_switch(x, 1);
+    mydsp_meta::set_cutoff_1(x, 100);
+    mydsp_meta::set_cutoff_2_(x, 200);
+    failures += mydsp_meta::get_int(x) != 0;
+    failures += mydsp_meta::get_cutoff_2(x) != 3000;
+#endif
+
+    failures += x.fHslider0 != 100 || x.fHslider1 != 200 || x.fHslider2 != 3000;
+
+    if (failures)
+        std::fprintf(stderr, "%d failures\n", failures);
+    return failures ? 1 : 0;
+}